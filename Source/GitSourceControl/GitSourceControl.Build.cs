@@ -14,6 +14,9 @@ public class GitSourceControl : ModuleRules
 				"InputCore",
 				"DesktopWidgets",
 				"SourceControl",
+				"HTTP",
+				"Json",
+				"WebSockets",
 			}
 		);
 
@@ -23,6 +26,11 @@ public class GitSourceControl : ModuleRules
 			PrivateDependencyModuleNames.Add("CoreUObject");
 			PrivateDependencyModuleNames.Add("EditorFramework");
 			PrivateDependencyModuleNames.Add("UnrealEd");
+			// needed to prefetch status of assets opened or selected
+			PrivateDependencyModuleNames.Add("AssetRegistry");
+			PrivateDependencyModuleNames.Add("ContentBrowser");
+			// needed to reload the Gitalong config when it changes
+			PrivateDependencyModuleNames.Add("DirectoryWatcher");
 		}
 
 		UnsafeTypeCastWarningLevel = WarningLevel.Error;
@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlClaimIndex.h"
+#include "GitSourceControlSpreadEngine.h"
+
+void FGitSourceControlClaimIndex::Rebuild(const TArray<FGitSourceControlState>& InStates)
+{
+	FWriteScopeLock WriteLock(Lock);
+	Claims.Empty(InStates.Num());
+	ClaimIds.Empty(InStates.Num());
+	AuthorClaimIds.Empty();
+	HostClaimIds.Empty();
+	BranchClaimIds.Empty();
+	for(TBitArray<>& Bits : SpreadBits)
+	{
+		Bits.Empty(InStates.Num());
+	}
+
+	for(const FGitSourceControlState& InState : InStates)
+	{
+		UpdateInternal(InState);
+	}
+	LastRebuildTime = InStates.Num() > 0 ? FPlatformTime::Seconds() : 0.0;
+}
+
+bool FGitSourceControlClaimIndex::Update(const FGitSourceControlState& InState)
+{
+	FWriteScopeLock WriteLock(Lock);
+	return UpdateInternal(InState);
+}
+
+void FGitSourceControlClaimIndex::Reset()
+{
+	Rebuild(TArray<FGitSourceControlState>());
+}
+
+int32 FGitSourceControlClaimIndex::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return ClaimIds.Num();
+}
+
+double FGitSourceControlClaimIndex::GetLastRebuildTime() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return LastRebuildTime;
+}
+
+bool FGitSourceControlClaimIndex::Find(const FString& InFilename, FGitClaim& OutClaim) const
+{
+	FReadScopeLock ReadLock(Lock);
+	if(const int32* ClaimId = ClaimIds.Find(InFilename))
+	{
+		OutClaim = Claims[*ClaimId];
+		return true;
+	}
+	return false;
+}
+
+void FGitSourceControlClaimIndex::MergeCloneSpread(FGitSourceControlState& InOutState) const
+{
+	ECommitSpread Spread = InOutState.LastCommitSpread & ~FGitSourceControlSpreadEngine::CloneSpreadMask;
+	FGitClaim Claim;
+	if(Find(InOutState.LocalFilename, Claim) && EnumHasAnyFlags(Claim.Spread, FGitSourceControlSpreadEngine::CloneSpreadMask))
+	{
+		Spread |= Claim.Spread & FGitSourceControlSpreadEngine::CloneSpreadMask;
+		InOutState.LastCommitSha = Claim.CommitSha;
+		InOutState.LastCommitHost = Claim.Host;
+		InOutState.LastCommitAuthor = Claim.Author;
+		InOutState.LastCommitRemoteBranches = Claim.Branches;
+	}
+	InOutState.LastCommitSpread = Spread;
+}
+
+TArray<FString> FGitSourceControlClaimIndex::GetFilesByAuthor(const FString& InAuthor) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return GetFilesInternal(AuthorClaimIds, InAuthor);
+}
+
+TArray<FString> FGitSourceControlClaimIndex::GetFilesByHost(const FString& InHost) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return GetFilesInternal(HostClaimIds, InHost);
+}
+
+TArray<FString> FGitSourceControlClaimIndex::GetFilesByBranch(const FString& InBranch) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return GetFilesInternal(BranchClaimIds, InBranch);
+}
+
+TArray<FString> FGitSourceControlClaimIndex::GetFilesBySpread(ECommitSpread InFlag) const
+{
+	TArray<FString> Files;
+	const uint8 Flag = static_cast<uint8>(InFlag);
+	if(Flag == 0 || !FMath::IsPowerOfTwo(Flag))
+	{
+		return Files;
+	}
+
+	FReadScopeLock ReadLock(Lock);
+	for(TConstSetBitIterator<> It(SpreadBits[FMath::FloorLog2(Flag)]); It; ++It)
+	{
+		Files.Add(Claims[It.GetIndex()].Filename);
+	}
+	return Files;
+}
+
+bool FGitSourceControlClaimIndex::IsClaim(const FGitSourceControlState& InState)
+{
+	return EnumHasAnyFlags(InState.LastCommitSpread, FGitSourceControlSpreadEngine::CloneSpreadMask | ECommitSpread::LocalUncommitted)
+		|| GitSpreadPredicates::Is(InState.LastCommitSpread, EGitSpreadPredicate::CheckedOut | EGitSpreadPredicate::CheckedOutOther);
+}
+
+void FGitSourceControlClaimIndex::GetBranches(const FGitSourceControlState& InState, TArray<FGitInternedString>& OutBranches)
+{
+	OutBranches = InState.LastCommitLocalBranches;
+	for(const FGitInternedString& Branch : InState.LastCommitRemoteBranches)
+	{
+		OutBranches.AddUnique(Branch);
+	}
+}
+
+bool FGitSourceControlClaimIndex::UpdateInternal(const FGitSourceControlState& InState)
+{
+	const bool bClaim = IsClaim(InState);
+	const int32* ClaimId = ClaimIds.Find(InState.LocalFilename);
+	if(ClaimId != nullptr)
+	{
+		const FGitClaim& Claim = Claims[*ClaimId];
+		if(bClaim && Claim.Spread == InState.LastCommitSpread && Claim.CommitSha == InState.LastCommitSha && Claim.Host == InState.LastCommitHost && Claim.Author == InState.LastCommitAuthor)
+		{
+			// branches are interned: compared as integers
+			TArray<FGitInternedString> Branches;
+			GetBranches(InState, Branches);
+			if(Claim.Branches == Branches)
+			{
+				return false;
+			}
+		}
+		RemoveInternal(*ClaimId);
+	}
+
+	if(bClaim)
+	{
+		AddInternal(InState);
+		return true;
+	}
+	return ClaimId != nullptr;
+}
+
+void FGitSourceControlClaimIndex::AddInternal(const FGitSourceControlState& InState)
+{
+	FGitClaim Claim;
+	Claim.Filename = InState.LocalFilename;
+	Claim.Spread = InState.LastCommitSpread;
+	Claim.CommitSha = InState.LastCommitSha;
+	GetBranches(InState, Claim.Branches);
+	Claim.Host = InState.LastCommitHost;
+	Claim.Author = InState.LastCommitAuthor;
+
+	const int32 ClaimId = Claims.Add(MoveTemp(Claim));
+	const FGitClaim& AddedClaim = Claims[ClaimId];
+	ClaimIds.Add(AddedClaim.Filename, ClaimId);
+	if(!AddedClaim.Author.IsEmpty())
+	{
+		AuthorClaimIds.FindOrAdd(AddedClaim.Author).Add(ClaimId);
+	}
+	if(!AddedClaim.Host.IsEmpty())
+	{
+		HostClaimIds.FindOrAdd(AddedClaim.Host).Add(ClaimId);
+	}
+	for(const FGitInternedString& Branch : AddedClaim.Branches)
+	{
+		BranchClaimIds.FindOrAdd(Branch).Add(ClaimId);
+	}
+
+	const uint8 Spread = static_cast<uint8>(AddedClaim.Spread);
+	for(int32 FlagIndex = 0; FlagIndex < NumSpreadFlags; FlagIndex++)
+	{
+		TBitArray<>& Bits = SpreadBits[FlagIndex];
+		if(Bits.Num() <= ClaimId)
+		{
+			Bits.Add(false, ClaimId + 1 - Bits.Num());
+		}
+		Bits[ClaimId] = (Spread & (1 << FlagIndex)) != 0;
+	}
+}
+
+void FGitSourceControlClaimIndex::RemoveInternal(int32 InClaimId)
+{
+	const FGitClaim& Claim = Claims[InClaimId];
+
+	auto RemoveFromMap = [InClaimId](TMap<FGitInternedString, TSet<int32>>& InOutMap, const FGitInternedString& InKey)
+	{
+		if(TSet<int32>* Ids = InOutMap.Find(InKey))
+		{
+			Ids->Remove(InClaimId);
+			if(Ids->Num() == 0)
+			{
+				InOutMap.Remove(InKey);
+			}
+		}
+	};
+	RemoveFromMap(AuthorClaimIds, Claim.Author);
+	RemoveFromMap(HostClaimIds, Claim.Host);
+	for(const FGitInternedString& Branch : Claim.Branches)
+	{
+		RemoveFromMap(BranchClaimIds, Branch);
+	}
+	for(TBitArray<>& Bits : SpreadBits)
+	{
+		if(Bits.IsValidIndex(InClaimId))
+		{
+			Bits[InClaimId] = false;
+		}
+	}
+
+	ClaimIds.Remove(Claim.Filename);
+	Claims.RemoveAt(InClaimId);
+}
+
+TArray<FString> FGitSourceControlClaimIndex::GetFilesInternal(const TMap<FGitInternedString, TSet<int32>>& InMap, FStringView InKey) const
+{
+	TArray<FString> Files;
+	// a value never interned cannot be claimed by anyone
+	const FGitInternedString Key = FGitInternedString::Find(InKey);
+	if(Key.IsEmpty())
+	{
+		return Files;
+	}
+	if(const TSet<int32>* Ids = InMap.Find(Key))
+	{
+		Files.Reserve(Ids->Num());
+		for(const int32 ClaimId : *Ids)
+		{
+			Files.Add(Claims[ClaimId].Filename);
+		}
+	}
+	return Files;
+}
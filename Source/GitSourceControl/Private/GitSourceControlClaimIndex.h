@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "Containers/SparseArray.h"
+#include "Misc/ScopeRWLock.h"
+#include "GitSourceControlState.h"
+
+/** Claim of a file by any clone of the team, as reported by Gitalong */
+struct FGitClaim
+{
+	/** Absolute filename */
+	FString Filename;
+
+	/** The spread of the last commit for this file */
+	ECommitSpread Spread = ECommitSpread::Unknown;
+
+	/** Sha of the last commit for this file, empty for uncommitted changes */
+	FString CommitSha;
+
+	/** Local and remote branch names where the last commit for this file lives */
+	TArray<FGitInternedString> Branches;
+
+	/** Hostname of the clone owning the claim */
+	FGitInternedString Host;
+
+	/** Author of the claim */
+	FGitInternedString Author;
+};
+
+/**
+ * Repository wide index of the files claimed by the team.
+ *
+ * Built from a single whole repository Gitalong query on connection, then kept up to date from status results.
+ * Only files changed by other clones, with uncommitted local changes, or whose spread makes them checked out (here or elsewhere, such as commits in another branch) are claims:
+ * files whose last commit is in every branch are not indexed, so that the index stays the size of the team's work in progress rather than a copy of the state cache.
+ * Secondary maps by author, host and branch and a bitmap per spread flag let queries run in time proportional to their result.
+ * All methods are thread safe.
+ */
+class FGitSourceControlClaimIndex
+{
+public:
+	/** Replace the whole index with the provided states (files that are not claims are skipped) */
+	void Rebuild(const TArray<FGitSourceControlState>& InStates);
+
+	/** Does a state claim its file: changed by another clone, uncommitted local changes, or checked out (IsCheckedOut() or IsCheckedOutOther()) */
+	static bool IsClaim(const FGitSourceControlState& InState);
+
+	/**
+	 * Add, update or remove (when not claimed anymore) the claim of a file.
+	 * @returns true if the index changed
+	 */
+	bool Update(const FGitSourceControlState& InState);
+
+	/** Empty the index */
+	void Reset();
+
+	/** Number of claimed files */
+	int32 Num() const;
+
+	/** Time (FPlatformTime::Seconds) of the last whole repository rebuild, 0 if never built */
+	double GetLastRebuildTime() const;
+
+	/** Get a copy of the claim of a file, if any */
+	bool Find(const FString& InFilename, FGitClaim& OutClaim) const;
+
+	/** Replace the bits of other clones in the spread of a state, and its last commit, with the claim of its file (local bits are kept) */
+	void MergeCloneSpread(FGitSourceControlState& InOutState) const;
+
+	/** Files claimed by an author */
+	TArray<FString> GetFilesByAuthor(const FString& InAuthor) const;
+
+	/** Files claimed from a host */
+	TArray<FString> GetFilesByHost(const FString& InHost) const;
+
+	/** Files claimed in a branch (local or remote branch name) */
+	TArray<FString> GetFilesByBranch(const FString& InBranch) const;
+
+	/** Files having the provided spread flag (a single flag) in their spread */
+	TArray<FString> GetFilesBySpread(ECommitSpread InFlag) const;
+
+private:
+	/** Number of ECommitSpread flags (one bitmap each) */
+	static constexpr int32 NumSpreadFlags = 8;
+
+	/** Local and remote branches of a state, without duplicates */
+	static void GetBranches(const FGitSourceControlState& InState, TArray<FGitInternedString>& OutBranches);
+
+	/** Helpers that expect the lock to be held */
+	bool UpdateInternal(const FGitSourceControlState& InState);
+	void AddInternal(const FGitSourceControlState& InState);
+	void RemoveInternal(int32 InClaimId);
+	TArray<FString> GetFilesInternal(const TMap<FGitInternedString, TSet<int32>>& InMap, FStringView InKey) const;
+
+	/** Claims, addressed by a stable id */
+	TSparseArray<FGitClaim> Claims;
+
+	/** Primary index: absolute filename to claim id */
+	TMap<FString, int32> ClaimIds;
+
+	/** Secondary indices: author, host and branch to claim ids */
+	TMap<FGitInternedString, TSet<int32>> AuthorClaimIds;
+	TMap<FGitInternedString, TSet<int32>> HostClaimIds;
+	TMap<FGitInternedString, TSet<int32>> BranchClaimIds;
+
+	/** One bit per claim id for each spread flag */
+	TBitArray<> SpreadBits[NumSpreadFlags];
+
+	/** Time of the last whole repository rebuild */
+	double LastRebuildTime = 0.0;
+
+	/** Lock for all the above */
+	mutable FRWLock Lock;
+};
@@ -0,0 +1,383 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlClaimJournal.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "ISourceControlModule.h"
+#include "GitSourceControlUtils.h"
+
+namespace GitJournalConstants
+{
+	/** First and maximum delay between two replay attempts while Gitalong is unreachable */
+	const double InitialBackoff = 1.0;
+	const double MaxBackoff = 60.0;
+
+	/** Delay between two checks of the journal when idle */
+	const uint32 IdleWaitMs = 1000;
+
+	/**
+	 * Start of the error lines of a Gitalong command that could not run or reach its store, as opposed to a command it refused:
+	 * the launch failure reported by GitSourceControlUtils, the last line of the Python traceback of a network error, and the fatal errors of Git remotes.
+	 * Only matched at the start of a line, never within filenames or shas.
+	 */
+	const TCHAR* UnreachableMarkers[] = {
+		TEXT("Failed to launch '"),
+		TEXT("requests.exceptions."), TEXT("urllib3.exceptions."), TEXT("ConnectionError:"), TEXT("ConnectionRefusedError:"), TEXT("TimeoutError:"), TEXT("socket.gaierror:"),
+		TEXT("fatal: unable to access '"), TEXT("fatal: Could not read from remote repository"),
+	};
+}
+
+/** Did a failed Gitalong command fail to run or to reach its store, rather than being refused (eg. a file already claimed by someone else) */
+static bool IsUnreachable(const FString& InPathToGitalongBinary, const TArray<FString>& InErrorMessages)
+{
+	if(!FPaths::FileExists(InPathToGitalongBinary))
+	{
+		return true;
+	}
+	for(const FString& ErrorMessage : InErrorMessages)
+	{
+		const FString Line = ErrorMessage.TrimStart();
+		for(const TCHAR* UnreachableMarker : GitJournalConstants::UnreachableMarkers)
+		{
+			if(Line.StartsWith(UnreachableMarker, ESearchCase::CaseSensitive))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+FGitSourceControlClaimJournal::~FGitSourceControlClaimJournal()
+{
+	Shutdown();
+}
+
+void FGitSourceControlClaimJournal::Start(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot)
+{
+	if(Thread != nullptr)
+	{
+		return;
+	}
+
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		PathToGitalongBinary = InPathToGitalongBinary;
+		RepositoryRoot = InRepositoryRoot;
+		JournalFilename = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Gitalong") / TEXT("ClaimJournal.txt"));
+		LoadJournal();
+	}
+
+	bStopping = false;
+	WakeUpEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("GitalongClaimJournal"), 0, TPri_BelowNormal);
+}
+
+void FGitSourceControlClaimJournal::Shutdown()
+{
+	if(Thread != nullptr)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	if(WakeUpEvent != nullptr)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeUpEvent);
+		WakeUpEvent = nullptr;
+	}
+}
+
+bool FGitSourceControlClaimJournal::IsRunning() const
+{
+	return Thread != nullptr;
+}
+
+void FGitSourceControlClaimJournal::Append(const FString& InCommand, const TArray<FString>& InFiles)
+{
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Command = InCommand;
+		Entry.Files = InFiles;
+		TrackPendingClaims(Entry, 1);
+
+		// Commit the entry to disk before returning
+		const FString Line = InCommand + TEXT("\t") + FString::Join(InFiles, TEXT("\t")) + LINE_TERMINATOR;
+		FFileHelper::SaveStringToFile(Line, *JournalFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+	}
+	if(WakeUpEvent != nullptr)
+	{
+		WakeUpEvent->Trigger();
+	}
+}
+
+bool FGitSourceControlClaimJournal::IsOnline() const
+{
+	return bOnline;
+}
+
+void FGitSourceControlClaimJournal::ReportUnreachable(const TArray<FString>& InFiles)
+{
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		// a single file is enough to tell whether the store answers again
+		ProbeFiles.Reset();
+		if(InFiles.Num() > 0)
+		{
+			ProbeFiles.Add(InFiles[0]);
+		}
+	}
+	bOnline = false;
+}
+
+bool FGitSourceControlClaimJournal::IsClaimPending(const FString& InFilename) const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return PendingClaims.Contains(InFilename);
+}
+
+void FGitSourceControlClaimJournal::DiscardClaim(const FString& InFilename)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	if(PendingClaims.Remove(InFilename) == 0)
+	{
+		return;
+	}
+	for(FEntry& Entry : Entries)
+	{
+		if(Entry.Command == TEXT("claim"))
+		{
+			Entry.Files.Remove(InFilename);
+		}
+	}
+	Entries.RemoveAll([](const FEntry& Entry) { return Entry.Files.Num() == 0; });
+	SaveJournal();
+	UE_LOG(LogSourceControl, Warning, TEXT("ClaimJournal: discarded claim of '%s' already claimed by someone else"), *InFilename);
+}
+
+void FGitSourceControlClaimJournal::RecordStatus(const TArray<FString>& InGitalongResults)
+{
+	const FDateTime Now = FDateTime::Now();
+	FScopeLock ScopeLock(&CriticalSection);
+	for(const FString& Result : InGitalongResults)
+	{
+		// <status> <filename> <commit> <branches> <host> <author>
+		TArray<FString> Splits;
+		Result.ParseIntoArray(Splits, TEXT(" "));
+		if(Splits.Num() > 1)
+		{
+			LastKnownStatuses.Add(Splits[1], TPair<FString, FDateTime>(Result, Now));
+		}
+	}
+}
+
+bool FGitSourceControlClaimJournal::GetLastKnownStatus(const FString& InRelativeFilename, FString& OutResult, FDateTime& OutTimeStamp) const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	if(const TPair<FString, FDateTime>* Status = LastKnownStatuses.Find(InRelativeFilename))
+	{
+		OutResult = Status->Key;
+		OutTimeStamp = Status->Value;
+		return true;
+	}
+	return false;
+}
+
+void FGitSourceControlClaimJournal::GetLastKnownStatuses(const FString& InRelativePath, TArray<FString>& OutResults) const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	if(const TPair<FString, FDateTime>* Status = LastKnownStatuses.Find(InRelativePath))
+	{
+		OutResults.Add(Status->Key);
+		return;
+	}
+	const FString DirectoryPrefix = InRelativePath / TEXT("");
+	for(const TPair<FString, TPair<FString, FDateTime>>& Status : LastKnownStatuses)
+	{
+		if(Status.Key.StartsWith(DirectoryPrefix))
+		{
+			OutResults.Add(Status.Value.Key);
+		}
+	}
+}
+
+uint32 FGitSourceControlClaimJournal::Run()
+{
+	double Backoff = 0.0;
+	while(!bStopping)
+	{
+		FEntry Entry;
+		FString GitalongBinary;
+		FString Root;
+		{
+			FScopeLock ScopeLock(&CriticalSection);
+			if(Entries.Num() > 0)
+			{
+				Entry = Entries[0];
+			}
+			GitalongBinary = PathToGitalongBinary;
+			Root = RepositoryRoot;
+		}
+
+		if(Entry.Command.IsEmpty())
+		{
+			if(bOnline)
+			{
+				WakeUpEvent->Wait(GitJournalConstants::IdleWaitMs);
+			}
+			else if(ProbeStatus(GitalongBinary, Root))
+			{
+				UE_LOG(LogSourceControl, Log, TEXT("ClaimJournal: gitalong is reachable again"));
+				Backoff = 0.0;
+				bOnline = true;
+			}
+			else
+			{
+				// Nothing to replay, but statuses are served from the last known ones until the live status succeeds again
+				Backoff = FMath::Clamp(Backoff * 2.0, GitJournalConstants::InitialBackoff, GitJournalConstants::MaxBackoff);
+				WakeUpEvent->Wait(FTimespan::FromSeconds(Backoff));
+			}
+			continue;
+		}
+
+		TArray<FString> Results;
+		TArray<FString> ErrorMessages;
+		const bool bSuccess = (Entry.Command == TEXT("claim"))
+			? GitSourceControlUtils::RunClaim(GitalongBinary, Root, TArray<FString>(), Entry.Files, Results, ErrorMessages)
+			: GitSourceControlUtils::RunCommand(Entry.Command, GitalongBinary, Root, TArray<FString>(), Entry.Files, Results, ErrorMessages);
+		if(bSuccess)
+		{
+			PopEntry(Entry);
+			Backoff = 0.0;
+			bOnline = true;
+		}
+		else if(!IsUnreachable(GitalongBinary, ErrorMessages))
+		{
+			// Gitalong answered but refused the command: retrying it would block every later entry behind it forever
+			UE_LOG(LogSourceControl, Warning, TEXT("ClaimJournal: gitalong %s rejected, dropped from the journal: %s"), *Entry.Command, *FString::Join(ErrorMessages, TEXT(" ")));
+			if(Entry.Command == TEXT("claim"))
+			{
+				// the user was already allowed to edit these files
+				AsyncTask(ENamedThreads::GameThread, [Files = Entry.Files]()
+				{
+					GitSourceControlUtils::DisplayRejectedClaimsNotification(Files, FString());
+				});
+			}
+			PopEntry(Entry);
+			Backoff = 0.0;
+			bOnline = true;
+		}
+		else
+		{
+			bOnline = false;
+			Backoff = FMath::Clamp(Backoff * 2.0, GitJournalConstants::InitialBackoff, GitJournalConstants::MaxBackoff);
+			UE_LOG(LogSourceControl, Warning, TEXT("ClaimJournal: gitalong %s failed, retrying in %.0fs"), *Entry.Command, Backoff);
+			WakeUpEvent->Wait(FTimespan::FromSeconds(Backoff));
+		}
+	}
+	return 0;
+}
+
+void FGitSourceControlClaimJournal::Stop()
+{
+	bStopping = true;
+	if(WakeUpEvent != nullptr)
+	{
+		WakeUpEvent->Trigger();
+	}
+}
+
+void FGitSourceControlClaimJournal::PopEntry(const FEntry& InEntry)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	// The entry may have been altered by DiscardClaim() in the meantime: only drop it if it is still the same
+	if(Entries.Num() > 0 && Entries[0].Command == InEntry.Command && Entries[0].Files == InEntry.Files)
+	{
+		TrackPendingClaims(Entries[0], -1);
+		Entries.RemoveAt(0);
+		SaveJournal();
+	}
+}
+
+bool FGitSourceControlClaimJournal::ProbeStatus(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot)
+{
+	TArray<FString> Files;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		Files = ProbeFiles;
+	}
+	if(Files.Num() == 0)
+	{
+		Files.Add(InRepositoryRoot);
+	}
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	if(!GitSourceControlUtils::RunCommand(TEXT("status"), InPathToGitalongBinary, InRepositoryRoot, TArray<FString>(), Files, Results, ErrorMessages))
+	{
+		return false;
+	}
+	RecordStatus(Results);
+	return true;
+}
+
+void FGitSourceControlClaimJournal::SaveJournal() const
+{
+	FString Content;
+	for(const FEntry& Entry : Entries)
+	{
+		Content += Entry.Command + TEXT("\t") + FString::Join(Entry.Files, TEXT("\t")) + LINE_TERMINATOR;
+	}
+	FFileHelper::SaveStringToFile(Content, *JournalFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+void FGitSourceControlClaimJournal::LoadJournal()
+{
+	Entries.Reset();
+	PendingClaims.Reset();
+
+	TArray<FString> Lines;
+	if(FFileHelper::LoadFileToStringArray(Lines, *JournalFilename))
+	{
+		for(const FString& Line : Lines)
+		{
+			TArray<FString> Splits;
+			Line.ParseIntoArray(Splits, TEXT("\t"));
+			if(Splits.Num() > 0)
+			{
+				FEntry& Entry = Entries.AddDefaulted_GetRef();
+				Entry.Command = Splits[0];
+				Splits.RemoveAt(0);
+				Entry.Files = MoveTemp(Splits);
+				TrackPendingClaims(Entry, 1);
+			}
+		}
+		if(Entries.Num() > 0)
+		{
+			UE_LOG(LogSourceControl, Log, TEXT("ClaimJournal: %d command(s) left to replay from a previous session"), Entries.Num());
+		}
+	}
+}
+
+void FGitSourceControlClaimJournal::TrackPendingClaims(const FEntry& InEntry, int32 InDelta)
+{
+	if(InEntry.Command != TEXT("claim"))
+	{
+		return;
+	}
+	for(const FString& File : InEntry.Files)
+	{
+		int32& Count = PendingClaims.FindOrAdd(File);
+		Count += InDelta;
+		if(Count <= 0)
+		{
+			PendingClaims.Remove(File);
+		}
+	}
+}
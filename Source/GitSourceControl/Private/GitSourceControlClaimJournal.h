@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+
+class FEvent;
+class FRunnableThread;
+
+/**
+ * Local write-ahead journal of Gitalong "claim" and "update" commands.
+ *
+ * Commands are committed to a journal file in the Saved/ directory and return immediately;
+ * a background thread replays them to Gitalong in order, with an exponential backoff while Gitalong is unreachable.
+ * Commands that Gitalong answers but refuses (eg. a file claimed by someone else first) are dropped rather than retried, with a notification for rejected claims.
+ * Gitalong is only deemed unreachable when it cannot be launched or reports a network error, never from the rest of its error messages.
+ * While offline, status reads are served from the last known Gitalong status of each file, along with its age,
+ * and the failed status is retried in the background with the same backoff until Gitalong answers again.
+ * Any Gitalong compatible binary can be used as a stand-in claim store to exercise pauses, slowness or outages.
+ * All methods are thread safe.
+ */
+class FGitSourceControlClaimJournal : public FRunnable
+{
+public:
+	virtual ~FGitSourceControlClaimJournal();
+
+	/** Load any entry left by a previous session and start replaying in the background */
+	void Start(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot);
+
+	/** Stop the background thread (entries not yet replayed stay in the journal file for the next session) */
+	void Shutdown();
+
+	/** Is the journal replaying commands */
+	bool IsRunning() const;
+
+	/** Commit a Gitalong command to the journal, to be replayed in the background */
+	void Append(const FString& InCommand, const TArray<FString>& InFiles);
+
+	/** Was the last Gitalong command successful */
+	bool IsOnline() const;
+
+	/** Flag Gitalong as unreachable after a status command of these files failed: the status is retried in the background until it succeeds */
+	void ReportUnreachable(const TArray<FString>& InFiles);
+
+	/** Is a claim of this file (absolute filename) waiting to be replayed */
+	bool IsClaimPending(const FString& InFilename) const;
+
+	/** Drop the pending claims of a file, since it turned out to be claimed by someone else */
+	void DiscardClaim(const FString& InFilename);
+
+	/** Remember the results of a successful Gitalong "status" command */
+	void RecordStatus(const TArray<FString>& InGitalongResults);
+
+	/** Get the last known Gitalong status of a file (relative filename), and when it was recorded */
+	bool GetLastKnownStatus(const FString& InRelativeFilename, FString& OutResult, FDateTime& OutTimeStamp) const;
+
+	/** Append the last known Gitalong status of a file, or of all the files of a directory (relative path) */
+	void GetLastKnownStatuses(const FString& InRelativePath, TArray<FString>& OutResults) const;
+
+	/** FRunnable interface */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	/** A journaled Gitalong command */
+	struct FEntry
+	{
+		FString Command;
+		TArray<FString> Files;
+	};
+
+	/** Write the whole journal file (expect the critical section to be held) */
+	void SaveJournal() const;
+
+	/** Read entries left in the journal file (expect the critical section to be held) */
+	void LoadJournal();
+
+	/** Register or unregister claims of an entry (expect the critical section to be held) */
+	void TrackPendingClaims(const FEntry& InEntry, int32 InDelta);
+
+	/** Drop the first entry once replayed or rejected, unless DiscardClaim() altered it in the meantime */
+	void PopEntry(const FEntry& InEntry);
+
+	/** Retry the live status that failed, while offline with nothing to replay; returns true if Gitalong is back */
+	bool ProbeStatus(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot);
+
+	/** Path to the journal file */
+	FString JournalFilename;
+
+	/** Path to the Gitalong binary used to replay commands */
+	FString PathToGitalongBinary;
+
+	/** Root of the repository to replay commands in */
+	FString RepositoryRoot;
+
+	/** Commands waiting to be replayed, in order */
+	TArray<FEntry> Entries;
+
+	/** Number of pending claims by absolute filename */
+	TMap<FString, int32> PendingClaims;
+
+	/** Files of the last status command that failed, retried to detect when Gitalong is back */
+	TArray<FString> ProbeFiles;
+
+	/** Last known Gitalong status line and its time, by relative filename */
+	TMap<FString, TPair<FString, FDateTime>> LastKnownStatuses;
+
+	/** Lock for all the above */
+	mutable FCriticalSection CriticalSection;
+
+	/** Wake up the background thread when a new entry is appended */
+	FEvent* WakeUpEvent = nullptr;
+
+	/** Background replay thread */
+	FRunnableThread* Thread = nullptr;
+
+	FThreadSafeBool bStopping = false;
+	FThreadSafeBool bOnline = true;
+};
@@ -0,0 +1,390 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlClaimStore.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "ISourceControlModule.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "GitSourceControlGitalongConfig.h"
+#include "GitSourceControlState.h"
+
+namespace GitClaimStoreConstants
+{
+	/** Minimum delay between two refreshes of the snapshot */
+	const double RefreshInterval = 2.0;
+
+	/** Give up on a request after this delay */
+	const float RequestTimeout = 10.0f;
+
+	/** Stop waiting for the completion of a request this long after its own timeout */
+	const uint32 CompletionMarginMs = 2000;
+
+	/** Header advertising the version of the store, and query parameter to ask for the delta since a version */
+	const TCHAR* VersionHeader = TEXT("X-Gitalong-Version");
+	const TCHAR* SinceParameter = TEXT("since");
+}
+
+bool FGitSourceControlClaimStore::Configure(const FGitSourceControlGitalongConfig& InConfig)
+{
+	FWriteScopeLock WriteLock(Lock);
+	StoreUrl = InConfig.GetStoreUrl();
+	StoreHeaders = InConfig.GetStoreHeaders();
+	ETag.Empty();
+	Version = INDEX_NONE;
+	Commits.Reset();
+	FileCommits.Reset();
+	LastRefreshTime = 0.0;
+	if(StoreUrl.IsEmpty())
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("ClaimStore: no store_url in the Gitalong config"));
+		return false;
+	}
+	return true;
+}
+
+bool FGitSourceControlClaimStore::IsConfigured() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return !StoreUrl.IsEmpty();
+}
+
+bool FGitSourceControlClaimStore::Refresh(TArray<FString>& OutErrorMessages)
+{
+	FScopeLock ScopeLock(&RefreshCriticalSection);
+
+	FString Url;
+	TMap<FString, FString> Headers;
+	{
+		FReadScopeLock ReadLock(Lock);
+		if(StoreUrl.IsEmpty() || (FPlatformTime::Seconds() - LastRefreshTime) < GitClaimStoreConstants::RefreshInterval)
+		{
+			return false;
+		}
+		Url = StoreUrl;
+		Headers = StoreHeaders;
+		if(!ETag.IsEmpty())
+		{
+			Headers.Add(TEXT("If-None-Match"), ETag);
+		}
+		if(Version != INDEX_NONE)
+		{
+			Url += FString::Printf(TEXT("%s%s=%lld"), Url.Contains(TEXT("?")) ? TEXT("&") : TEXT("?"), GitClaimStoreConstants::SinceParameter, Version);
+		}
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->SetVerb(TEXT("GET"));
+	Request->SetURL(Url);
+	Request->SetTimeout(GitClaimStoreConstants::RequestTimeout);
+	for(const auto& Header : Headers)
+	{
+		Request->SetHeader(Header.Key, Header.Value);
+	}
+	// Called from worker threads, possibly while the game thread waits for a synchronous command and does not tick the HTTP manager:
+	// the request must complete on the HTTP thread, and the wait is bounded anyway
+	// (the event is shared with the delegate, which may still fire after a timed out wait)
+	const TSharedRef<FEventRef, ESPMode::ThreadSafe> CompletionEvent = MakeShared<FEventRef, ESPMode::ThreadSafe>(EEventMode::ManualReset);
+	Request->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+	Request->OnProcessRequestComplete().BindLambda([CompletionEvent](FHttpRequestPtr InRequest, FHttpResponsePtr InResponse, bool bInSucceeded)
+	{
+		(*CompletionEvent)->Trigger();
+	});
+	bool bCompleted = false;
+	if(Request->ProcessRequest())
+	{
+		bCompleted = (*CompletionEvent)->Wait((uint32)(GitClaimStoreConstants::RequestTimeout * 1000.0f) + GitClaimStoreConstants::CompletionMarginMs);
+		if(!bCompleted)
+		{
+			Request->CancelRequest();
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	LastRefreshTime = FPlatformTime::Seconds();
+	if(!bCompleted)
+	{
+		OutErrorMessages.Add(FString::Printf(TEXT("ClaimStore: no answer from '%s'"), *StoreUrl));
+		return false;
+	}
+	const FHttpResponsePtr Response = Request->GetResponse();
+	if(!Response.IsValid())
+	{
+		OutErrorMessages.Add(FString::Printf(TEXT("ClaimStore: no response from '%s'"), *StoreUrl));
+		return false;
+	}
+	const int32 ResponseCode = Response->GetResponseCode();
+	UE_LOG(LogSourceControl, Verbose, TEXT("ClaimStore: %d in %.3lfs (%d bytes)"), ResponseCode, LastRefreshTime - StartTime, Response->GetContentLength());
+	if(ResponseCode == EHttpResponseCodes::NotModified)
+	{
+		return false;
+	}
+	if(!EHttpResponseCodes::IsOk(ResponseCode))
+	{
+		OutErrorMessages.Add(FString::Printf(TEXT("ClaimStore: '%s' answered %d"), *StoreUrl, ResponseCode));
+		// Start over with a full download next time
+		ETag.Empty();
+		Version = INDEX_NONE;
+		return false;
+	}
+
+	if(!ParsePayload(Response->GetContentAsString()))
+	{
+		OutErrorMessages.Add(FString::Printf(TEXT("ClaimStore: unexpected payload from '%s'"), *StoreUrl));
+		ETag.Empty();
+		Version = INDEX_NONE;
+		return false;
+	}
+	ETag = Response->GetHeader(TEXT("ETag"));
+	const FString VersionHeader = Response->GetHeader(GitClaimStoreConstants::VersionHeader);
+	Version = VersionHeader.IsEmpty() ? INDEX_NONE : FCString::Atoi64(*VersionHeader);
+	return true;
+}
+
+bool FGitSourceControlClaimStore::ApplyPayload(const FString& InContent, TSet<FString>& OutAffectedFiles)
+{
+	FWriteScopeLock WriteLock(Lock);
+	return ParsePayload(InContent, &OutAffectedFiles);
+}
+
+bool FGitSourceControlClaimStore::ParsePayload(const FString& InContent, TSet<FString>* OutAffectedFiles)
+{
+	// Files of a commit about to be replaced or removed are affected, as well as the ones of its replacement
+	auto AddAffectedFiles = [this, OutAffectedFiles](const FString& InKey)
+	{
+		if(OutAffectedFiles != nullptr)
+		{
+			if(const FGitStoreCommit* Commit = Commits.Find(InKey))
+			{
+				OutAffectedFiles->Append(Commit->Changes);
+			}
+		}
+	};
+
+	TSharedPtr<FJsonValue> Payload;
+	if(!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(InContent), Payload) || !Payload.IsValid())
+	{
+		return false;
+	}
+
+	// Delta since the version of the snapshot
+	const TSharedPtr<FJsonObject>* Object;
+	if(Payload->TryGetObject(Object) && (*Object)->HasField(TEXT("upserts")))
+	{
+		for(const TSharedPtr<FJsonValue>& Value : (*Object)->GetArrayField(TEXT("upserts")))
+		{
+			const TSharedPtr<FJsonObject>* CommitObject;
+			if(Value->TryGetObject(CommitObject))
+			{
+				FGitStoreCommit Commit = ParseCommit(**CommitObject);
+				AddAffectedFiles(Commit.GetKey());
+				if(OutAffectedFiles != nullptr)
+				{
+					OutAffectedFiles->Append(Commit.Changes);
+				}
+				AddCommit(MoveTemp(Commit));
+			}
+		}
+		const TArray<TSharedPtr<FJsonValue>>* Removals;
+		if((*Object)->TryGetArrayField(TEXT("removals"), Removals))
+		{
+			for(const TSharedPtr<FJsonValue>& Value : *Removals)
+			{
+				AddAffectedFiles(Value->AsString());
+				RemoveCommit(Value->AsString());
+			}
+		}
+		return true;
+	}
+
+	// Full record, either as is or wrapped by JSONBin
+	const TArray<TSharedPtr<FJsonValue>>* Record;
+	if(!Payload->TryGetArray(Record) && !(Payload->TryGetObject(Object) && (*Object)->TryGetArrayField(TEXT("record"), Record)))
+	{
+		return false;
+	}
+	if(OutAffectedFiles != nullptr)
+	{
+		for(const auto& Entry : Commits)
+		{
+			OutAffectedFiles->Append(Entry.Value.Changes);
+		}
+	}
+	Commits.Reset();
+	FileCommits.Reset();
+	for(const TSharedPtr<FJsonValue>& Value : *Record)
+	{
+		const TSharedPtr<FJsonObject>* CommitObject;
+		if(Value->TryGetObject(CommitObject))
+		{
+			FGitStoreCommit Commit = ParseCommit(**CommitObject);
+			if(OutAffectedFiles != nullptr)
+			{
+				OutAffectedFiles->Append(Commit.Changes);
+			}
+			AddCommit(MoveTemp(Commit));
+		}
+	}
+	return true;
+}
+
+void FGitSourceControlClaimStore::AddCommit(FGitStoreCommit&& InCommit)
+{
+	const FString Key = InCommit.GetKey();
+	RemoveCommit(Key);
+	for(const FString& Change : InCommit.Changes)
+	{
+		FileCommits.FindOrAdd(Change).Add(Key);
+	}
+	Commits.Add(Key, MoveTemp(InCommit));
+}
+
+void FGitSourceControlClaimStore::RemoveCommit(const FString& InKey)
+{
+	FGitStoreCommit Commit;
+	if(!Commits.RemoveAndCopyValue(InKey, Commit))
+	{
+		return;
+	}
+	for(const FString& Change : Commit.Changes)
+	{
+		if(TSet<FString>* Keys = FileCommits.Find(Change))
+		{
+			Keys->Remove(InKey);
+			if(Keys->Num() == 0)
+			{
+				FileCommits.Remove(Change);
+			}
+		}
+	}
+}
+
+FGitStoreCommit FGitSourceControlClaimStore::ParseCommit(const FJsonObject& InObject)
+{
+	FGitStoreCommit Commit;
+	InObject.TryGetStringField(TEXT("sha"), Commit.Sha);
+	InObject.TryGetStringField(TEXT("host"), Commit.Host);
+	InObject.TryGetStringField(TEXT("user"), Commit.User);
+	InObject.TryGetStringArrayField(TEXT("changes"), Commit.Changes);
+	const TSharedPtr<FJsonObject>* Branches;
+	if(InObject.TryGetObjectField(TEXT("branches"), Branches))
+	{
+		(*Branches)->TryGetStringArrayField(TEXT("local"), Commit.LocalBranches);
+		(*Branches)->TryGetStringArrayField(TEXT("remote"), Commit.RemoteBranches);
+	}
+	return Commit;
+}
+
+ECommitSpread FGitSourceControlClaimStore::GetCloneSpread(const FGitStoreCommit& InCommit, const FString& InLocalHost, const FString& InBranchName)
+{
+	if(InCommit.Host.Equals(InLocalHost, ESearchCase::IgnoreCase))
+	{
+		// Our own clone: the local spread comes from refs
+		return ECommitSpread::Unknown;
+	}
+	if(InCommit.Sha.IsEmpty())
+	{
+		return ECommitSpread::CloneUncommitted;
+	}
+	if(InCommit.LocalBranches.Contains(InBranchName) || InCommit.RemoteBranches.Contains(FString(TEXT("origin/")) + InBranchName))
+	{
+		return ECommitSpread::CloneMatchingBranch;
+	}
+	return ECommitSpread::CloneOtherBranch;
+}
+
+void FGitSourceControlClaimStore::GetClaims(const FString& InRepositoryRoot, const FString& InBranchName, TArray<FGitSourceControlState>& OutStates) const
+{
+	const FString LocalHost = FPlatformProcess::ComputerName();
+
+	// A file changed by several commits keeps its most relevant claim: uncommitted, then matching branch, then other branch
+	TMap<FString, int32> StateIndices;
+
+	FReadScopeLock ReadLock(Lock);
+	for(const auto& Entry : Commits)
+	{
+		const FGitStoreCommit& Commit = Entry.Value;
+		const ECommitSpread Spread = GetCloneSpread(Commit, LocalHost, InBranchName);
+		if(Spread == ECommitSpread::Unknown)
+		{
+			continue;
+		}
+		// interned once for all the files of the commit
+		const TArray<FGitInternedString> LocalBranches = FGitInternedString::InternAll(Commit.LocalBranches);
+		const TArray<FGitInternedString> RemoteBranches = FGitInternedString::InternAll(Commit.RemoteBranches);
+		const FGitInternedString Host(Commit.Host);
+		const FGitInternedString Author(Commit.User);
+		for(const FString& Change : Commit.Changes)
+		{
+			int32& StateIndex = StateIndices.FindOrAdd(Change, INDEX_NONE);
+			if(StateIndex == INDEX_NONE)
+			{
+				StateIndex = OutStates.Emplace(FPaths::ConvertRelativePathToFull(InRepositoryRoot, Change));
+			}
+			else if(static_cast<uint8>(OutStates[StateIndex].LastCommitSpread) >= static_cast<uint8>(Spread))
+			{
+				continue;
+			}
+			FGitSourceControlState& State = OutStates[StateIndex];
+			State.LastCommitSpread = Spread;
+			State.LastCommitSha = Commit.Sha;
+			State.LastCommitLocalBranches = LocalBranches;
+			State.LastCommitRemoteBranches = RemoteBranches;
+			State.LastCommitHost = Host;
+			State.LastCommitAuthor = Author;
+		}
+	}
+}
+
+void FGitSourceControlClaimStore::GetClaims(const FString& InRepositoryRoot, const FString& InBranchName, const TSet<FString>& InRelativeFilenames, TArray<FGitSourceControlState>& OutStates) const
+{
+	const FString LocalHost = FPlatformProcess::ComputerName();
+
+	FReadScopeLock ReadLock(Lock);
+	OutStates.Reserve(OutStates.Num() + InRelativeFilenames.Num());
+	for(const FString& RelativeFilename : InRelativeFilenames)
+	{
+		FGitSourceControlState& State = OutStates.Emplace_GetRef(FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename));
+		State.LastCommitSpread = ECommitSpread::Unknown;
+		const TSet<FString>* Keys = FileCommits.Find(RelativeFilename);
+		if(Keys == nullptr)
+		{
+			continue;
+		}
+		// same priority as for the whole snapshot: uncommitted, then matching branch, then other branch
+		for(const FString& Key : *Keys)
+		{
+			const FGitStoreCommit& Commit = Commits.FindChecked(Key);
+			const ECommitSpread Spread = GetCloneSpread(Commit, LocalHost, InBranchName);
+			if(Spread == ECommitSpread::Unknown || static_cast<uint8>(State.LastCommitSpread) >= static_cast<uint8>(Spread))
+			{
+				continue;
+			}
+			State.LastCommitSpread = Spread;
+			State.LastCommitSha = Commit.Sha;
+			State.LastCommitLocalBranches = FGitInternedString::InternAll(Commit.LocalBranches);
+			State.LastCommitRemoteBranches = FGitInternedString::InternAll(Commit.RemoteBranches);
+			State.LastCommitHost = FGitInternedString(Commit.Host);
+			State.LastCommitAuthor = FGitInternedString(Commit.User);
+		}
+	}
+}
+
+void FGitSourceControlClaimStore::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+	StoreUrl.Empty();
+	StoreHeaders.Reset();
+	ETag.Empty();
+	Version = INDEX_NONE;
+	Commits.Reset();
+	FileCommits.Reset();
+	LastRefreshTime = 0.0;
+}
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeRWLock.h"
+
+class FGitSourceControlGitalongConfig;
+class FGitSourceControlState;
+class FJsonObject;
+enum class ECommitSpread : uint8;
+
+/** A commit, or the uncommitted changes of a clone, as recorded in the Gitalong claim store */
+struct FGitStoreCommit
+{
+	/** Sha of the commit, empty for uncommitted changes */
+	FString Sha;
+
+	/** Hostname of the clone that recorded the commit */
+	FString Host;
+
+	/** User of the clone that recorded the commit */
+	FString User;
+
+	/** Local and remote branch names where the commit lives */
+	TArray<FString> LocalBranches;
+	TArray<FString> RemoteBranches;
+
+	/** Repository relative filenames changed by the commit */
+	TArray<FString> Changes;
+
+	/** Key of the commit in the snapshot: its sha, or the clone for uncommitted changes */
+	FString GetKey() const
+	{
+		return Sha.IsEmpty() ? Host + TEXT("/") + User : Sha;
+	}
+};
+
+/**
+ * In-plugin client of the Gitalong claim store, keeping a local snapshot of the team claims.
+ *
+ * The store location and headers come from the Gitalong config of the repository (store_url and store_headers).
+ * The snapshot is refreshed with conditional requests (If-None-Match on the ETag of the last response), so a quiet team costs one 304 round trip.
+ * Stores that advertise a version number (X-Gitalong-Version header) are asked for the delta since the version of the snapshot,
+ * as a {"version", "upserts", "removals"} payload; others send the full record each time it changes.
+ * All methods are thread safe.
+ */
+class FGitSourceControlClaimStore
+{
+public:
+	/** Take the store location from the Gitalong config of the repository */
+	bool Configure(const FGitSourceControlGitalongConfig& InConfig);
+
+	/** Is a store location known */
+	bool IsConfigured() const;
+
+	/** Refresh the snapshot with a conditional request, at most every few seconds; returns true if the snapshot changed */
+	bool Refresh(TArray<FString>& OutErrorMessages);
+
+	/** Get the claims of the other clones from the snapshot, with their spread relative to our current branch */
+	void GetClaims(const FString& InRepositoryRoot, const FString& InBranchName, TArray<FGitSourceControlState>& OutStates) const;
+
+	/** Get the claims of some files (repository relative filenames) from the snapshot: a state for each file, with an unknown spread if nobody else claims it */
+	void GetClaims(const FString& InRepositoryRoot, const FString& InBranchName, const TSet<FString>& InRelativeFilenames, TArray<FGitSourceControlState>& OutStates) const;
+
+	/** Apply a full record or a delta pushed by a relay, and list the repository relative filenames whose claims changed */
+	bool ApplyPayload(const FString& InContent, TSet<FString>& OutAffectedFiles);
+
+	/** Forget the store location and snapshot */
+	void Reset();
+
+private:
+	/** Parse a full record or a delta payload into the snapshot, listing affected files if asked (expect the lock to be held for write) */
+	bool ParsePayload(const FString& InContent, TSet<FString>* OutAffectedFiles = nullptr);
+
+	/** Parse a commit object of the store */
+	static FGitStoreCommit ParseCommit(const FJsonObject& InObject);
+
+	/** Spread of a commit relative to our current branch, unknown for the commits of our own clone */
+	static ECommitSpread GetCloneSpread(const FGitStoreCommit& InCommit, const FString& InLocalHost, const FString& InBranchName);
+
+	/** Add or replace a commit of the snapshot, and remove one (expect the lock to be held for write) */
+	void AddCommit(FGitStoreCommit&& InCommit);
+	void RemoveCommit(const FString& InKey);
+
+	/** URL and headers of the store */
+	FString StoreUrl;
+	TMap<FString, FString> StoreHeaders;
+
+	/** ETag of the last response, and version of the snapshot if the store supports deltas */
+	FString ETag;
+	int64 Version = INDEX_NONE;
+
+	/** Commits recorded in the store, by key */
+	TMap<FString, FGitStoreCommit> Commits;
+
+	/** Keys of the commits changing each file, by repository relative filename */
+	TMap<FString, TSet<FString>> FileCommits;
+
+	/** Platform time of the last refresh */
+	double LastRefreshTime = 0.0;
+
+	/** Lock for the store location and snapshot */
+	mutable FRWLock Lock;
+
+	/** Serialize refreshes so concurrent workers share a single round trip */
+	FCriticalSection RefreshCriticalSection;
+};
@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlClaimSubscription.h"
+#include "HAL/PlatformTime.h"
+#include "IWebSocket.h"
+#include "ISourceControlModule.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "WebSocketsModule.h"
+#include "GitSourceControlModule.h"
+#include "GitSourceControlProvider.h"
+#include "GitSourceControlSpreadEngine.h"
+#include "GitSourceControlUtils.h"
+
+namespace GitClaimSubscriptionConstants
+{
+	/** Delay between two connection attempts to the relay */
+	const double ReconnectInterval = 10.0;
+}
+
+bool FGitSourceControlClaimSubscription::Connect(const FString& InRepositoryRoot, const FString& InRelayUrl, const TMap<FString, FString>& InHeaders)
+{
+	Disconnect();
+
+	RepositoryRoot = InRepositoryRoot;
+	RelayUrl = InRelayUrl;
+	Headers = InHeaders;
+	LastConnectionTime = FPlatformTime::Seconds();
+	if(RelayUrl.IsEmpty())
+	{
+		return false;
+	}
+
+	FWebSocketsModule& WebSockets = FModuleManager::LoadModuleChecked<FWebSocketsModule>("WebSockets");
+	WebSocket = WebSockets.CreateWebSocket(RelayUrl, FString(), Headers);
+	WebSocket->OnConnected().AddLambda([this]()
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("ClaimSubscription: connected to '%s'"), *RelayUrl);
+		bConnected = true;
+	});
+	WebSocket->OnConnectionError().AddLambda([this](const FString& InError)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("ClaimSubscription: cannot connect to '%s': %s"), *RelayUrl, *InError);
+		OnDisconnected();
+	});
+	WebSocket->OnClosed().AddLambda([this](int32 InStatusCode, const FString& InReason, bool bInWasClean)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("ClaimSubscription: disconnected from '%s' (%d %s)"), *RelayUrl, InStatusCode, *InReason);
+		OnDisconnected();
+	});
+	WebSocket->OnMessage().AddRaw(this, &FGitSourceControlClaimSubscription::OnMessage);
+	WebSocket->Connect();
+	return true;
+}
+
+void FGitSourceControlClaimSubscription::Disconnect()
+{
+	if(WebSocket.IsValid())
+	{
+		WebSocket->OnConnected().Clear();
+		WebSocket->OnConnectionError().Clear();
+		WebSocket->OnClosed().Clear();
+		WebSocket->OnMessage().Clear();
+		WebSocket->Close();
+		WebSocket.Reset();
+	}
+	bConnected = false;
+	AffectedFiles.Reset();
+}
+
+bool FGitSourceControlClaimSubscription::IsConnected() const
+{
+	return bConnected;
+}
+
+void FGitSourceControlClaimSubscription::OnMessage(const FString& InMessage)
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if(!GitSourceControl.GetProvider().GetClaimStore().ApplyPayload(InMessage, AffectedFiles))
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("ClaimSubscription: unexpected message from '%s'"), *RelayUrl);
+	}
+}
+
+void FGitSourceControlClaimSubscription::OnDisconnected()
+{
+	bConnected = false;
+	// Drop the connection on the next Tick, not from within its own callback
+	LastConnectionTime = FPlatformTime::Seconds();
+}
+
+bool FGitSourceControlClaimSubscription::Tick()
+{
+	if(!bConnected)
+	{
+		if(!RepositoryRoot.IsEmpty() && !RelayUrl.IsEmpty() && (FPlatformTime::Seconds() - LastConnectionTime) > GitClaimSubscriptionConstants::ReconnectInterval)
+		{
+			Connect(RepositoryRoot, RelayUrl, Headers);
+		}
+		return false;
+	}
+	if(AffectedFiles.Num() == 0)
+	{
+		return false;
+	}
+
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+
+	// Only the claims of the affected files changed: update them in the index, rather than rebuilding it from the whole snapshot
+	TArray<FGitSourceControlState> Claims;
+	Provider.GetClaimStore().GetClaims(RepositoryRoot, Provider.GetBranchName(), AffectedFiles, Claims);
+	AffectedFiles.Reset();
+
+	// Only the claims of other workstations come from the store: keep the local bits of the cached states
+	TArray<FGitSourceControlState> States;
+	for(const FGitSourceControlState& Claim : Claims)
+	{
+		const TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> CachedState = Provider.FindStateInternal(Claim.LocalFilename);
+		if(!CachedState.IsValid())
+		{
+			FGitClaim LocalClaim;
+			if(!Provider.GetClaimIndex().Find(Claim.LocalFilename, LocalClaim) || !EnumHasAnyFlags(LocalClaim.Spread, ECommitSpread::LocalUncommitted))
+			{
+				Provider.GetClaimIndex().Update(Claim);
+			}
+			continue;
+		}
+		FGitSourceControlState& State = States.Add_GetRef(*CachedState);
+		State.LastCommitSpread = (State.LastCommitSpread & ~FGitSourceControlSpreadEngine::CloneSpreadMask) | Claim.LastCommitSpread;
+		if(Claim.LastCommitSpread != ECommitSpread::Unknown)
+		{
+			State.LastCommitSha = Claim.LastCommitSha;
+			State.LastCommitLocalBranches = Claim.LastCommitLocalBranches;
+			State.LastCommitRemoteBranches = Claim.LastCommitRemoteBranches;
+			State.LastCommitHost = Claim.LastCommitHost;
+			State.LastCommitAuthor = Claim.LastCommitAuthor;
+		}
+		else
+		{
+			// the claim was released: drop its commit instead of leaving it on the file
+			State.LastCommitSha.Empty();
+			State.LastCommitLocalBranches.Reset();
+			State.LastCommitRemoteBranches.Reset();
+			State.LastCommitHost = FGitInternedString();
+			State.LastCommitAuthor = FGitInternedString();
+		}
+	}
+
+	return GitSourceControlUtils::UpdateCachedStates(States);
+}
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IWebSocket;
+
+/**
+ * Subscription to claim changes pushed by a relay of the Gitalong claim store.
+ *
+ * The relay location comes from the Gitalong config of the repository (relay_url), and it is sent the same headers as the claim store (store_headers).
+ * The relay sends the full record on connection, then a delta ({"version", "upserts", "removals"}) on each change of the store.
+ * Pushes are applied to the snapshot of the claim store client, and on the next Tick to the claims of the affected files only, in the claim index and the cached states.
+ * While connected, the claim store is not polled anymore; it is again as soon as the connection drops.
+ * Only used from the game thread.
+ */
+class FGitSourceControlClaimSubscription
+{
+public:
+	/** Connect to the relay of the repository (no-op if it has none) */
+	bool Connect(const FString& InRepositoryRoot, const FString& InRelayUrl, const TMap<FString, FString>& InHeaders);
+
+	/** Disconnect from the relay */
+	void Disconnect();
+
+	/** Is the relay pushing claim changes */
+	bool IsConnected() const;
+
+	/** Apply pushed claim changes to cached states, and reconnect when needed; returns true if any state was updated */
+	bool Tick();
+
+private:
+	/** Called when the relay pushes a message */
+	void OnMessage(const FString& InMessage);
+
+	/** Called when the connection fails or drops */
+	void OnDisconnected();
+
+	/** Root of the repository */
+	FString RepositoryRoot;
+
+	/** URL of the relay */
+	FString RelayUrl;
+
+	/** Headers of the connection requests, those of the claim store */
+	TMap<FString, FString> Headers;
+
+	/** Connection to the relay */
+	TSharedPtr<IWebSocket> WebSocket;
+
+	/** Repository relative filenames whose claims changed since the last Tick */
+	TSet<FString> AffectedFiles;
+
+	/** Platform time of the last connection attempt */
+	double LastConnectionTime = 0.0;
+
+	bool bConnected = false;
+};
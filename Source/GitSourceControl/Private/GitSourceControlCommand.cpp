@@ -1,8 +1,13 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "GitSourceControlCommand.h"
+#include "HAL/Event.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Misc/MemStack.h"
+#include "ISourceControlModule.h"
 #include "Modules/ModuleManager.h"
 #include "GitSourceControlModule.h"
+#include "GitSourceControlUtils.h"
 
 FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>& InOperation, const TSharedRef<class IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker, const FSourceControlOperationComplete& InOperationCompleteDelegate)
 	: Operation(InOperation)
@@ -11,6 +16,9 @@ FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourc
 	, bExecuteProcessed(0)
 	, bCommandSuccessful(false)
 	, bAutoDelete(true)
+	, bOptimistic(false)
+	, CompletionQueue(nullptr)
+	, CompletionEvent(nullptr)
 	, Concurrency(EConcurrency::Synchronous)
 {
 	// grab the providers settings here, so we don't access them once the worker thread is launched
@@ -23,15 +31,39 @@ FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourc
 
 bool FGitSourceControlCommand::DoWork()
 {
+	// transient parse data of the command is taken from the memory stack of the thread, and released at once when it is done
+	FMemMark Mark(FMemStack::Get());
+	// the plugin has no benchmark target: the allocation counts of the parsing are logged for each command instead,
+	// and its heap allocations are tagged for the low level memory tracker and Unreal Insights (-trace=memalloc,callstack)
+	LLM_SCOPE_BYNAME(TEXT("GitSourceControl/Command"));
+	GitSourceControlUtils::FParseAllocationCounts& Counts = GitSourceControlUtils::GetParseAllocationCounts();
+	Counts = GitSourceControlUtils::FParseAllocationCounts();
 	bCommandSuccessful = Worker->Execute(*this);
-	FPlatformAtomics::InterlockedExchange(&bExecuteProcessed, 1);
+	UE_LOG(LogSourceControl, Verbose, TEXT("%s: parsed %d lines, with %d bytes from the memory stack and %d heap copies"), *Worker->GetName().ToString(), Counts.Lines, Counts.StackBytes, Counts.HeapCopies);
+	const bool bResult = bCommandSuccessful;
+	Complete();
 
-	return bCommandSuccessful;
+	return bResult;
 }
 
 void FGitSourceControlCommand::Abandon()
+{
+	Complete();
+}
+
+void FGitSourceControlCommand::Complete()
 {
 	FPlatformAtomics::InterlockedExchange(&bExecuteProcessed, 1);
+	if(bAutoDelete && CompletionQueue != nullptr)
+	{
+		// Last access to this command from the worker thread: the game thread may delete it as soon as it is queued
+		CompletionQueue->Enqueue(this);
+	}
+	else if(CompletionEvent != nullptr)
+	{
+		// Synchronous commands are owned by the waiting thread until it is woken up
+		CompletionEvent->Trigger();
+	}
 }
 
 void FGitSourceControlCommand::DoThreadedWork()
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"
 #include "ISourceControlProvider.h"
 #include "Misc/IQueuedWork.h"
 
@@ -35,6 +36,9 @@ public:
 	 */
 	virtual void DoThreadedWork() override;
 
+	/** Flag the command as processed, and hand it over to the provider */
+	void Complete();
+
 	/** Save any results and call any registered callbacks. */
 	ECommandResult::Type ReturnResults();
 
@@ -66,6 +70,15 @@ public:
 	/** If true, this command will be automatically cleaned up in Tick() */
 	bool bAutoDelete;
 
+	/** If true, the worker already applied the expected result to the cache, so the command can run in the background even if issued synchronously */
+	bool bOptimistic;
+
+	/** Where the command pushes itself once executed, to be applied and deleted by the provider Tick() (auto deleted commands only) */
+	TQueue<FGitSourceControlCommand*, EQueueMode::Mpsc>* CompletionQueue;
+
+	/** Event triggered once executed, for synchronous commands to be waited on */
+	class FEvent* CompletionEvent;
+
 	/** Whether we are running multi-treaded or not*/
 	EConcurrency::Type Concurrency;
 
@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlCommitTable.h"
+#include "Misc/ScopeLock.h"
+
+FGitCommitRef FGitSourceControlCommitTable::FindOrAdd(FGitCommit&& InCommit)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	TWeakPtr<const FGitCommit, ESPMode::ThreadSafe>& Weak = Commits.FindOrAdd(InCommit.CommitId);
+	if(const FGitCommitPtr Shared = Weak.Pin())
+	{
+		return Shared.ToSharedRef();
+	}
+
+	const FGitCommitRef Commit = MakeShared<const FGitCommit, ESPMode::ThreadSafe>(MoveTemp(InCommit));
+	Weak = Commit;
+
+	// forget commits no history uses anymore, before they outnumber the live ones
+	if(Commits.Num() >= PurgeThreshold)
+	{
+		for(auto It = Commits.CreateIterator(); It; ++It)
+		{
+			if(!It.Value().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		PurgeThreshold = FMath::Max(64, 2 * Commits.Num());
+	}
+	return Commit;
+}
+
+int32 FGitSourceControlCommitTable::Num() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Commits.Num();
+}
+
+void FGitSourceControlCommitTable::Empty()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Commits.Empty();
+	PurgeThreshold = 64;
+}
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/DateTime.h"
+
+/** Metadata of a commit, shared by the revisions of all the files it touched */
+struct FGitCommit
+{
+	/** The full hexadecimal SHA1 id of the commit */
+	FString CommitId;
+
+	/** The short hexadecimal SHA1 id (8 first hex char out of 40) of the commit: the string to display */
+	FString ShortCommitId;
+
+	/** The numeric value of the short SHA1 (8 first hex char out of 40) */
+	int32 CommitIdNumber = 0;
+
+	/** The description of the commit */
+	FString Description;
+
+	/** The user that made the change */
+	FString UserName;
+
+	/** The date the commit was made */
+	FDateTime Date;
+};
+
+typedef TSharedRef<const FGitCommit, ESPMode::ThreadSafe> FGitCommitRef;
+typedef TSharedPtr<const FGitCommit, ESPMode::ThreadSafe> FGitCommitPtr;
+
+/**
+ * Commits of the loaded histories by object id, so that a commit that touched thousands of files is stored once for the revisions of all of them.
+ * Commits are immutable once added. The table only holds weak references: a commit is freed with the last history that uses it.
+ * All methods are thread safe.
+ */
+class FGitSourceControlCommitTable
+{
+public:
+	/** Get the commit of the same id if it is already known, or add the provided one */
+	FGitCommitRef FindOrAdd(FGitCommit&& InCommit);
+
+	/** Number of known commits (including the ones freed since the last purge) */
+	int32 Num() const;
+
+	/** Forget all commits (revisions keep the ones they use) */
+	void Empty();
+
+private:
+	TMap<FString, TWeakPtr<const FGitCommit, ESPMode::ThreadSafe>> Commits;
+
+	/** Number of commits above which freed ones are forgotten */
+	int32 PurgeThreshold = 64;
+
+	mutable FCriticalSection CriticalSection;
+};
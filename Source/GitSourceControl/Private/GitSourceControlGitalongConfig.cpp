@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlGitalongConfig.h"
+#include "DirectoryWatcherModule.h"
+#include "HAL/PlatformMisc.h"
+#include "IDirectoryWatcher.h"
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+void FGitSourceControlGitalongConfig::Load(const FString& InRepositoryRoot)
+{
+	Reset();
+
+	ConfigFilename = FPaths::Combine(InRepositoryRoot, TEXT(".gitalong.json"));
+	bLoadAttempted = true;
+	Reload();
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	if(IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get())
+	{
+		WatchedDirectory = InRepositoryRoot;
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(WatchedDirectory, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FGitSourceControlGitalongConfig::OnDirectoryChanged), DirectoryChangedHandle, IDirectoryWatcher::WatchOptions::IgnoreChangesInSubtree);
+	}
+}
+
+void FGitSourceControlGitalongConfig::Reset()
+{
+	if(DirectoryChangedHandle.IsValid())
+	{
+		if(FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+		{
+			if(IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+			{
+				DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory, DirectoryChangedHandle);
+			}
+		}
+		DirectoryChangedHandle.Reset();
+	}
+	WatchedDirectory.Empty();
+
+	FWriteScopeLock WriteLock(Lock);
+	bLoadAttempted = false;
+	bLoaded = false;
+	bModifyPermissions = false;
+	bTrackUncommitted = true;
+	StoreUrl.Empty();
+	StoreHeaders.Reset();
+	RelayUrl.Empty();
+}
+
+FString FGitSourceControlGitalongConfig::GetStoreUrl() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return StoreUrl;
+}
+
+TMap<FString, FString> FGitSourceControlGitalongConfig::GetStoreHeaders() const
+{
+	TMap<FString, FString> Headers;
+	{
+		FReadScopeLock ReadLock(Lock);
+		Headers = StoreHeaders;
+	}
+	if(Headers.Num() == 0)
+	{
+		// Default JSONBin access key, as read by CheckGitalongAvailability()
+		const FString AccessKey = FPlatformMisc::GetEnvironmentVariable(TEXT("PLAYSTHETIC_GITALONG_JSONBIN_ACCESS_KEY"));
+		if(!AccessKey.IsEmpty())
+		{
+			Headers.Add(TEXT("X-Access-Key"), AccessKey);
+		}
+	}
+	return Headers;
+}
+
+FString FGitSourceControlGitalongConfig::GetRelayUrl() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return RelayUrl;
+}
+
+void FGitSourceControlGitalongConfig::Reload()
+{
+	FString Content;
+	TSharedPtr<FJsonObject> Config;
+	const bool bFound = FFileHelper::LoadFileToString(Content, *ConfigFilename) && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Content), Config) && Config.IsValid();
+
+	FWriteScopeLock WriteLock(Lock);
+	Revision.Increment();
+	bLoaded = bFound;
+	StoreUrl.Empty();
+	StoreHeaders.Reset();
+	RelayUrl.Empty();
+	if(!bFound)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("GitalongConfig: no config in '%s'"), *ConfigFilename);
+		bModifyPermissions = false;
+		bTrackUncommitted = true;
+		return;
+	}
+
+	bool bValue = false;
+	bModifyPermissions = Config->TryGetBoolField(TEXT("modify_permissions"), bValue) && bValue;
+	bTrackUncommitted = !Config->TryGetBoolField(TEXT("track_uncommitted"), bValue) || bValue;
+
+	FString Value;
+	if(Config->TryGetStringField(TEXT("store_url"), Value))
+	{
+		StoreUrl = ExpandEnvironmentVariables(Value);
+	}
+	if(Config->TryGetStringField(TEXT("relay_url"), Value))
+	{
+		RelayUrl = ExpandEnvironmentVariables(Value);
+	}
+	const TSharedPtr<FJsonObject>* Headers;
+	if(Config->TryGetObjectField(TEXT("store_headers"), Headers))
+	{
+		for(const auto& Header : (*Headers)->Values)
+		{
+			StoreHeaders.Add(Header.Key, ExpandEnvironmentVariables(Header.Value->AsString()));
+		}
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("GitalongConfig: loaded '%s' (modify_permissions=%d track_uncommitted=%d)"), *ConfigFilename, (bool)bModifyPermissions, (bool)bTrackUncommitted);
+}
+
+void FGitSourceControlGitalongConfig::OnDirectoryChanged(const TArray<FFileChangeData>& InFileChanges)
+{
+	for(const FFileChangeData& FileChange : InFileChanges)
+	{
+		if(FPaths::IsSamePath(FileChange.Filename, ConfigFilename))
+		{
+			Reload();
+			return;
+		}
+	}
+}
+
+FString FGitSourceControlGitalongConfig::ExpandEnvironmentVariables(const FString& InValue)
+{
+	FString Value;
+	Value.Reserve(InValue.Len());
+	int32 Index = 0;
+	while(Index < InValue.Len())
+	{
+		if(InValue[Index] != TEXT('$'))
+		{
+			Value.AppendChar(InValue[Index++]);
+			continue;
+		}
+		int32 NameStart = Index + 1;
+		int32 NameEnd;
+		int32 End;
+		if(NameStart < InValue.Len() && InValue[NameStart] == TEXT('{'))
+		{
+			NameStart++;
+			NameEnd = InValue.Find(TEXT("}"), ESearchCase::CaseSensitive, ESearchDir::FromStart, NameStart);
+			if(NameEnd == INDEX_NONE)
+			{
+				Value.Append(InValue.Mid(Index));
+				break;
+			}
+			End = NameEnd + 1;
+		}
+		else
+		{
+			NameEnd = NameStart;
+			while(NameEnd < InValue.Len() && (FChar::IsAlnum(InValue[NameEnd]) || InValue[NameEnd] == TEXT('_')))
+			{
+				NameEnd++;
+			}
+			End = NameEnd;
+		}
+		if(NameEnd == NameStart)
+		{
+			// Not a variable
+			Value.AppendChar(InValue[Index++]);
+			continue;
+		}
+		Value.Append(FPlatformMisc::GetEnvironmentVariable(*InValue.Mid(NameStart, NameEnd - NameStart)));
+		Index = End;
+	}
+	return Value;
+}
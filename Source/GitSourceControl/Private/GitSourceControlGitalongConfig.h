@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/ScopeRWLock.h"
+
+struct FFileChangeData;
+
+/**
+ * In-memory copy of the Gitalong config of the repository (.gitalong.json at its root).
+ *
+ * Loaded once, then reloaded only when the Directory Watcher reports a change of the config file,
+ * so that flags such as modify_permissions or track_uncommitted can be queried from any thread without touching the disk or running Gitalong.
+ * All methods are thread safe.
+ */
+class FGitSourceControlGitalongConfig
+{
+public:
+	/** Load the config of the repository, and watch for changes of the config file */
+	void Load(const FString& InRepositoryRoot);
+
+	/** Stop watching for changes, and forget the config */
+	void Reset();
+
+	/** Was the config of the repository loaded, whether or not a config file was found (then it is watched for until Reset) */
+	bool IsLoadAttempted() const
+	{
+		return bLoadAttempted;
+	}
+
+	/** Was a config file found */
+	bool IsLoaded() const
+	{
+		return bLoaded;
+	}
+
+	/** Incremented each time the config file is read, so that users of its values can tell when to apply them again */
+	int32 GetRevision() const
+	{
+		return Revision.GetValue();
+	}
+
+	/** Does Gitalong make unclaimed files read-only ("modify_permissions") */
+	bool ModifiesPermissions() const
+	{
+		return bModifyPermissions;
+	}
+
+	/** Does Gitalong track uncommitted changes ("track_uncommitted"), true when unknown */
+	bool TracksUncommitted() const
+	{
+		return bTrackUncommitted;
+	}
+
+	/** URL of the claim store ("store_url"), with environment variables expanded */
+	FString GetStoreUrl() const;
+
+	/** Headers of requests to the claim store and its relay ("store_headers"), with environment variables expanded; the default JSONBin access key if none */
+	TMap<FString, FString> GetStoreHeaders() const;
+
+	/** URL of the relay pushing claim changes ("relay_url"), with environment variables expanded */
+	FString GetRelayUrl() const;
+
+	/** Expand $VAR and ${VAR} environment variables, like Gitalong does for its config values */
+	static FString ExpandEnvironmentVariables(const FString& InValue);
+
+private:
+	/** Read the config file */
+	void Reload();
+
+	/** Called by the Directory Watcher on changes at the root of the repository */
+	void OnDirectoryChanged(const TArray<FFileChangeData>& InFileChanges);
+
+	/** Path to the config file */
+	FString ConfigFilename;
+
+	/** Directory watched for changes of the config file, and the handle of the watch */
+	FString WatchedDirectory;
+	FDelegateHandle DirectoryChangedHandle;
+
+	/** Flags, lock free */
+	FThreadSafeBool bLoadAttempted = false;
+	FThreadSafeBool bLoaded = false;
+	FThreadSafeBool bModifyPermissions = false;
+	FThreadSafeBool bTrackUncommitted = true;
+
+	/** Number of reads of the config file */
+	FThreadSafeCounter Revision;
+
+	/** Claim store location */
+	FString StoreUrl;
+	TMap<FString, FString> StoreHeaders;
+	FString RelayUrl;
+
+	/** Lock for the strings above */
+	mutable FRWLock Lock;
+};
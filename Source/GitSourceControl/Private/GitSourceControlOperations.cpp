@@ -20,6 +20,8 @@ bool FGitConnectWorker::Execute(FGitSourceControlCommand& InCommand)
 {
 	check(InCommand.Operation->GetName() == GetName());
 
+	bool bSnapshotValidated = false;
+
 	// Check Git Availability
 	if (0 < InCommand.PathToGitBinary.Len() && GitSourceControlUtils::CheckGitAvailability(InCommand.PathToGitBinary))
 	{
@@ -29,12 +31,34 @@ bool FGitConnectWorker::Execute(FGitSourceControlCommand& InCommand)
 		ProjectDirs.Add(FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()));
 		if (0 < InCommand.PathToGitalongBinary.Len() && GitSourceControlUtils::CheckGitalongAvailability(InCommand.PathToGitalongBinary))
 		{
-			InCommand.bCommandSuccessful = GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, ProjectDirs, InCommand.ErrorMessages, States);
+			// With the states of the last session already shown, only query again the files that changed since
+			FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+			const FGitSourceControlSnapshot& Snapshot = GitSourceControl.GetProvider().GetSnapshot();
+			TArray<FString> StatusFiles;
+			FGitSnapshotKey CurrentKey;
+			if(Snapshot.IsLoaded() && FGitSourceControlSnapshot::ReadKey(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, CurrentKey)
+				&& Snapshot.GetInvalidatedFiles(InCommand.PathToGitBinary, CurrentKey, ProjectDirs, StatusFiles))
+			{
+				bSnapshotValidated = true;
+				UE_LOG(LogSourceControl, Log, TEXT("Snapshot: %d file(s) changed since the last session"), StatusFiles.Num());
+			}
+			else
+			{
+				StatusFiles = ProjectDirs;
+			}
+			InCommand.bCommandSuccessful = StatusFiles.Num() == 0 || GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, StatusFiles, InCommand.ErrorMessages, States);
 			if(!InCommand.bCommandSuccessful || InCommand.ErrorMessages.Num() > 0)
 			{
 				StaticCastSharedRef<FConnect>(InCommand.Operation)->SetErrorText(LOCTEXT("NotAGitRepository", "Failed to enable Git revision control. You need to initialize the project as a Git repository first."));
 				InCommand.bCommandSuccessful = false;
 			}
+			else
+			{
+				// Get all files claimed by the team at once to build the claim index
+				TArray<FString> ErrorMessages;
+				GitSourceControlUtils::RunGetClaims(InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, ErrorMessages, Claims);
+				InCommand.InfoMessages.Append(ErrorMessages);
+			}
 		} else {
 			StaticCastSharedRef<FConnect>(InCommand.Operation)->SetErrorText(LOCTEXT("GitalongNotFound", "Failed to enable Git source control. You need to install Gitalong and specify a valid path to gitalong executable."));
 			InCommand.bCommandSuccessful = false;
@@ -46,12 +70,75 @@ bool FGitConnectWorker::Execute(FGitSourceControlCommand& InCommand)
 		InCommand.bCommandSuccessful = false;
 	}
 
+	// publish the new claims and states right away, from this worker thread
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+	Provider.GetClaimIndex().Rebuild(Claims);
+	const bool bSnapshotLoaded = Provider.GetSnapshot().IsLoaded();
+	if(bSnapshotValidated)
+	{
+		// Files of the snapshot not queried again keep their local bits, but other clones may have claimed or released them meanwhile
+		TSet<FString> UpdatedFiles;
+		UpdatedFiles.Reserve(States.Num() + Provider.GetSnapshot().GetStates().Num());
+		for(const FGitSourceControlState& State : States)
+		{
+			UpdatedFiles.Add(State.LocalFilename);
+		}
+		const int32 NumQueried = States.Num();
+		for(const FGitSourceControlState& SnapshotState : Provider.GetSnapshot().GetStates())
+		{
+			bool bAlreadyUpdated = false;
+			UpdatedFiles.Add(SnapshotState.LocalFilename, &bAlreadyUpdated);
+			if(!bAlreadyUpdated)
+			{
+				// other commands may have published a newer state since it was loaded
+				const FGitSourceControlStateCache::FStatePtr CachedState = Provider.FindStateInternal(SnapshotState.LocalFilename);
+				Provider.GetClaimIndex().MergeCloneSpread(States.Add_GetRef(CachedState.IsValid() ? *CachedState : SnapshotState));
+			}
+		}
+		// as well as files claimed meanwhile that were not in the snapshot at all
+		for(const FGitSourceControlState& Claim : Claims)
+		{
+			bool bAlreadyUpdated = false;
+			UpdatedFiles.Add(Claim.LocalFilename, &bAlreadyUpdated);
+			if(!bAlreadyUpdated)
+			{
+				Provider.GetClaimIndex().MergeCloneSpread(States.Emplace_GetRef(Claim.LocalFilename));
+			}
+		}
+		UE_LOG(LogSourceControl, Log, TEXT("Snapshot: %d file(s) queried, %d refreshed from claims"), NumQueried, States.Num() - NumQueried);
+	}
+	GitSourceControlUtils::UpdateCachedStates(States);
+	if(bSnapshotLoaded && Provider.GetGitalongConfig().ModifiesPermissions())
+	{
+		// States of the snapshot were only cached: those confirmed unchanged were not published again, so apply their permissions now that they are validated
+		TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> ValidatedStates;
+		ValidatedStates.Reserve(States.Num());
+		for(const FGitSourceControlState& State : States)
+		{
+			if(const FGitSourceControlStateCache::FStatePtr CachedState = Provider.FindStateInternal(State.LocalFilename))
+			{
+				ValidatedStates.Add(CachedState.ToSharedRef());
+			}
+		}
+		Provider.GetPermissionManager().Apply(ValidatedStates);
+	}
+	Provider.GetSnapshot().Reset();
+
+	const FGitSourceControlStateCache& StateCache = Provider.GetStateCache();
+	const int32 NumFiles = StateCache.Num();
+	const SIZE_T AllocatedSize = StateCache.GetAllocatedSize();
+	UE_LOG(LogSourceControl, Log, TEXT("StateCache: %d file(s) in %.2lf MiB (%d bytes per file)"), NumFiles, AllocatedSize / (1024.0 * 1024.0), NumFiles > 0 ? (int32)(AllocatedSize / NumFiles) : 0);
+	const FGitSourceControlStringTable& StringTable = FGitSourceControlStringTable::Get();
+	UE_LOG(LogSourceControl, Log, TEXT("StringTable: %d string(s) in %.2lf MiB"), StringTable.Num(), StringTable.GetAllocatedSize() / (1024.0 * 1024.0));
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitConnectWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	return false;
 }
 
 FName FGitCheckOutWorker::GetName() const
@@ -59,19 +146,121 @@ FName FGitCheckOutWorker::GetName() const
 	return "CheckOut";
 }
 
+// Mark uncontended files as claimed right away so that the Editor lets the user edit them while the claim is confirmed in the background
+bool FGitCheckOutWorker::PrepareStates(FGitSourceControlCommand& InCommand)
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if(!GitSourceControl.AccessSettings().IsOptimisticCheckOutEnabled() || InCommand.Files.Num() == 0)
+	{
+		return false;
+	}
+
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+	for(const FString& File : InCommand.Files)
+	{
+		// A file already known to be changed by someone else needs the regular blocking round trip
+		if(Provider.GetStateInternal(File)->IsCheckedOutOther())
+		{
+			return false;
+		}
+	}
+
+	TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> ClaimedStates;
+	for(const FString& File : InCommand.Files)
+	{
+		const TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> ClaimedState = Provider.GetStateCache().Update(File, [this, &File](FGitSourceControlState& State)
+		{
+			if(State.IsCheckedOut())
+			{
+				return false;
+			}
+			OptimisticClaims.Add(File, State.LastCommitSpread);
+			State.LastCommitSpread = ECommitSpread::LocalUncommitted;
+			return true;
+		});
+		if(ClaimedState.IsValid())
+		{
+			ClaimedStates.Add(ClaimedState.ToSharedRef());
+		}
+	}
+
+	// Files made read-only by Gitalong must be writable right away too, not once the claim is confirmed
+	if(ClaimedStates.Num() > 0 && Provider.GetGitalongConfig().ModifiesPermissions())
+	{
+		Provider.GetPermissionManager().Apply(ClaimedStates);
+	}
+
+	// Nothing claimed (all files already checked out): keep the regular synchronous command
+	InCommand.bOptimistic = OptimisticClaims.Num() > 0;
+	return InCommand.bOptimistic;
+}
+
 bool FGitCheckOutWorker::Execute(FGitSourceControlCommand& InCommand)
 {
 	check(InCommand.Operation->GetName() == GetName());
-	InCommand.bCommandSuccessful = GitSourceControlUtils::RunClaim(InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), InCommand.Files, InCommand.InfoMessages, InCommand.ErrorMessages);
+	InCommand.bCommandSuccessful = GitSourceControlUtils::RunGitalongCommand(TEXT("claim"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.InfoMessages, InCommand.ErrorMessages);
+	bClaimSucceeded = InCommand.bCommandSuccessful;
 	// now update the status of our files
 	GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitCheckOutWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	bool bUpdated = false;
+	if(OptimisticClaims.Num() == 0)
+	{
+		return bUpdated;
+	}
+
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+
+	TSet<FString> ReportedFiles;
+	for(const FGitSourceControlState& InState : States)
+	{
+		ReportedFiles.Add(InState.LocalFilename);
+	}
+
+	// Confirm or roll back each optimistic claim
+	TArray<FString> RejectedFiles;
+	FString RejectedBy;
+	for(const auto& Claim : OptimisticClaims)
+	{
+		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(Claim.Key);
+		if(!ReportedFiles.Contains(Claim.Key) && !bClaimSucceeded)
+		{
+			// No fresh status to rely on: restore what we knew before claiming
+			const ECommitSpread PreviousSpread = Claim.Value;
+			State = Provider.GetStateCache().Update(Claim.Key, [PreviousSpread](FGitSourceControlState& NewState)
+			{
+				NewState.LastCommitSpread = PreviousSpread;
+				return true;
+			}).ToSharedRef();
+			bUpdated = true;
+		}
+		if(State->IsCheckedOutOther() || (!bClaimSucceeded && !State->IsCheckedOut()))
+		{
+			RejectedFiles.Add(Claim.Key);
+			if(RejectedBy.IsEmpty())
+			{
+				RejectedBy = State->LastCommitAuthor.ToString();
+			}
+		}
+	}
+
+	if(RejectedFiles.Num() > 0)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("CheckOut: %d optimistic claim(s) rolled back"), RejectedFiles.Num());
+		GitSourceControlUtils::DisplayRejectedClaimsNotification(RejectedFiles, RejectedBy);
+	}
+
+	return bUpdated;
 }
 
 static FText ParseCommitResults(const TArray<FString>& InResults)
@@ -131,12 +320,16 @@ bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 	// now update the status of our files
 	GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitCheckInWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	return false;
 }
 
 FName FGitMarkForAddWorker::GetName() const
@@ -153,12 +346,16 @@ bool FGitMarkForAddWorker::Execute(FGitSourceControlCommand& InCommand)
 	// now update the status of our files
 	GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitMarkForAddWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	return false;
 }
 
 FName FGitDeleteWorker::GetName() const
@@ -172,21 +369,26 @@ bool FGitDeleteWorker::Execute(FGitSourceControlCommand& InCommand)
 
 	InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("rm"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), InCommand.Files, InCommand.InfoMessages, InCommand.ErrorMessages);
 
-	// @todo Check if Gitalong preferences are set to not track uncommitted files in which case this not necessary.
-	if (InCommand.bCommandSuccessful)
+	// Only needed if Gitalong tracks uncommitted files
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if (InCommand.bCommandSuccessful && GitSourceControl.GetProvider().GetGitalongConfig().TracksUncommitted())
 	{
-		InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("update"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), InCommand.Files, InCommand.InfoMessages, InCommand.ErrorMessages);
+		InCommand.bCommandSuccessful = GitSourceControlUtils::RunGitalongCommand(TEXT("update"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.InfoMessages, InCommand.ErrorMessages);
 	}
 	
 	// now update the status of our files
 	GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitDeleteWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	return false;
 }
 
 
@@ -248,22 +450,27 @@ bool FGitRevertWorker::Execute(FGitSourceControlCommand& InCommand)
 		InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("checkout"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), OtherThanAddedExistingFiles, InCommand.InfoMessages, InCommand.ErrorMessages);
 	}
 
-	// @todo Check if Gitalong preferences are set to not track uncommitted files in which case this not necessary.
+	// Only needed if Gitalong tracks uncommitted files.
 	// Only doing the update on rm and reset because gitalong update will run on checkout with the post-checkout hook.
-	if (InCommand.bCommandSuccessful && (MissingFiles.Num() > 0 || AllExistingFiles.Num() > 0))
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if (InCommand.bCommandSuccessful && (MissingFiles.Num() > 0 || AllExistingFiles.Num() > 0) && GitSourceControl.GetProvider().GetGitalongConfig().TracksUncommitted())
 	{
-		InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("update"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
+		InCommand.bCommandSuccessful = GitSourceControlUtils::RunGitalongCommand(TEXT("update"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
 	}
 
 	// now update the status of our files
 	GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitRevertWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	return false;
 }
 
 FName FGitSyncWorker::GetName() const
@@ -271,25 +478,83 @@ FName FGitSyncWorker::GetName() const
    return "Sync";
 }
 
+// Gather locally modified or claimed files from the state cache and claim data, while on the main thread
+bool FGitSyncWorker::PrepareStates(FGitSourceControlCommand& InCommand)
+{
+   FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+   FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+   bAbortOnConflictForecast = GitSourceControl.AccessSettings().IsAbortSyncOnConflictForecastEnabled();
+
+   const TArray<FSourceControlStateRef> ChangedStates = Provider.GetCachedStateByPredicate(EGitStateIndex::Modified | EGitStateIndex::CheckedOut, [](const FSourceControlStateRef& State)
+   {
+      return State->IsModified() || State->IsCheckedOut();
+   });
+   for(const FSourceControlStateRef& State : ChangedStates)
+   {
+      LocalChanges.Add(State->GetFilename());
+   }
+   LocalChanges.Append(Provider.GetClaimIndex().GetFilesBySpread(ECommitSpread::LocalUncommitted));
+
+   return false;
+}
+
 bool FGitSyncWorker::Execute(FGitSourceControlCommand& InCommand)
 {
-   // pull the branch to get remote changes by rebasing any local commits (not merging them to avoid complex graphs)
-   // (this cannot work if any local files are modified but not committed)
+   // fetch first, so that we can forecast conflicts before any working tree mutation
    {
       TArray<FString> Parameters;
-      Parameters.Add(TEXT("--rebase --autostash origin HEAD"));
-      InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("pull"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters, TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
+      Parameters.Add(TEXT("origin HEAD"));
+      InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("fetch"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters, TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
+   }
+
+   // intersect incoming changes with local changes and claims
+   if(InCommand.bCommandSuccessful && LocalChanges.Num() > 0)
+   {
+      TArray<FString> IncomingFiles;
+      InCommand.bCommandSuccessful = GitSourceControlUtils::RunGetIncomingChanges(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, TEXT("FETCH_HEAD"), InCommand.ErrorMessages, IncomingFiles);
+
+      TArray<FString> ConflictingFiles;
+      for(const FString& IncomingFile : IncomingFiles)
+      {
+         if(LocalChanges.Contains(IncomingFile))
+         {
+            ConflictingFiles.Add(IncomingFile);
+         }
+      }
+      if(ConflictingFiles.Num() > 0)
+      {
+         TArray<FString>& Messages = bAbortOnConflictForecast ? InCommand.ErrorMessages : InCommand.InfoMessages;
+         Messages.Add(FString::Printf(TEXT("Incoming commits change %d locally modified or claimed file(s):"), ConflictingFiles.Num()));
+         Messages.Append(ConflictingFiles);
+         if(bAbortOnConflictForecast)
+         {
+            Messages.Add(TEXT("Sync aborted before touching the working tree."));
+            return false;
+         }
+      }
+   }
+
+   // rebase the branch on the fetched remote changes (not merging them to avoid complex graphs)
+   if(InCommand.bCommandSuccessful)
+   {
+      TArray<FString> Parameters;
+      Parameters.Add(TEXT("--autostash FETCH_HEAD"));
+      InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("rebase"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, Parameters, TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
    }
 
    // now update the status of our files
    GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+   // publish the new states right away, from this worker thread
+   GitSourceControlUtils::UpdateCachedStates(States);
+
    return InCommand.bCommandSuccessful;
 }
 
 bool FGitSyncWorker::UpdateStates() const
 {
-   return GitSourceControlUtils::UpdateCachedStates(States);
+   // states were already published by Execute()
+   return false;
 }
 
 FName FGitUpdateStatusWorker::GetName() const
@@ -339,26 +604,29 @@ bool FGitUpdateStatusWorker::Execute(FGitSourceControlCommand& InCommand)
 
 	// don't use the ShouldUpdateModifiedState() hint here as it is specific to Perforce: the above normal Git status has already told us this information (like Git and Mercurial)
 
-	return InCommand.bCommandSuccessful;
-}
-
-bool FGitUpdateStatusWorker::UpdateStates() const
-{
-	bool bUpdated = GitSourceControlUtils::UpdateCachedStates(States);
-
-	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>( "GitSourceControl" );
-	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
 
 	// add history, if any
-	for(const auto& History : Histories)
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlStateCache& StateCache = GitSourceControl.GetProvider().GetStateCache();
+	for(auto& History : Histories)
 	{
-		const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(History.Key);
-		State->History = History.Value;
-		State->TimeStamp = FDateTime::Now();
-		bUpdated = true;
+		StateCache.Update(History.Key, [&History](FGitSourceControlState& State)
+		{
+			State.History = MoveTemp(History.Value);
+			State.TimeStamp = FDateTime::Now();
+			return true;
+		});
 	}
 
-	return bUpdated;
+	return InCommand.bCommandSuccessful;
+}
+
+bool FGitUpdateStatusWorker::UpdateStates() const
+{
+	// states were already published by Execute()
+	return false;
 }
 
 FName FGitCopyWorker::GetName() const
@@ -376,18 +644,23 @@ bool FGitCopyWorker::Execute(FGitSourceControlCommand& InCommand)
 	// => the following is to "MarkForAdd" the redirector, but it still need to be committed by selecting the whole directory and "check-in"
 	InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("add"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), InCommand.Files, InCommand.InfoMessages, InCommand.ErrorMessages);
 
-	// @todo Check if Gitalong preferences are set to not track uncommitted files in which case this not necessary.
-	if (InCommand.bCommandSuccessful)
+	// Only needed if Gitalong tracks uncommitted files
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if (InCommand.bCommandSuccessful && GitSourceControl.GetProvider().GetGitalongConfig().TracksUncommitted())
 	{
-		InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("update"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
+		InCommand.bCommandSuccessful = GitSourceControlUtils::RunGitalongCommand(TEXT("update"), InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, TArray<FString>(), InCommand.InfoMessages, InCommand.ErrorMessages);
 	}
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(OutStates);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitCopyWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(OutStates);
+	// states were already published by Execute()
+	return false;
 }
 
 FName FGitResolveWorker::GetName() const
@@ -408,12 +681,16 @@ bool FGitResolveWorker::Execute( class FGitSourceControlCommand& InCommand )
 	// now update the status of our files
 	GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToGitalongBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ErrorMessages, States);
 
+	// publish the new states right away, from this worker thread
+	GitSourceControlUtils::UpdateCachedStates(States);
+
 	return InCommand.bCommandSuccessful;
 }
 
 bool FGitResolveWorker::UpdateStates() const
 {
-	return GitSourceControlUtils::UpdateCachedStates(States);
+	// states were already published by Execute()
+	return false;
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -20,6 +20,9 @@ public:
 public:
 	/** Temporary states for results */
 	TArray<FGitSourceControlState> States;
+
+	/** Files claimed by the team, to build the claim index */
+	TArray<FGitSourceControlState> Claims;
 };
 
 /** Lock (check-out) a set of files using Gitalong. */
@@ -29,12 +32,19 @@ public:
 	virtual ~FGitCheckOutWorker() {}
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
+	virtual bool PrepareStates(class FGitSourceControlCommand& InCommand) override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
 	virtual bool UpdateStates() const override;
 
 public:
 	/** Temporary states for results */
 	TArray<FGitSourceControlState> States;
+
+	/** Spread of the files claimed optimistically before the command was issued, used to roll back a rejected claim */
+	TMap<FString, ECommitSpread> OptimisticClaims;
+
+	/** Whether Gitalong accepted the claim */
+	bool bClaimSucceeded = false;
 };
 
 /** Commit (check-in) a set of file to the local depot. */
@@ -97,19 +107,26 @@ public:
 	TArray<FGitSourceControlState> States;
 };
 
-/** Git pull --rebase to update branch from its configure remote */
+/** Git fetch and rebase to update branch from its configure remote, after forecasting conflicts with local changes */
 class FGitSyncWorker : public IGitSourceControlWorker
 {
 public:
 	virtual ~FGitSyncWorker() {}
 	// IGitSourceControlWorker interface
 	virtual FName GetName() const override;
+	virtual bool PrepareStates(class FGitSourceControlCommand& InCommand) override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
 	virtual bool UpdateStates() const override;
 
 public:
 	/// Map of filenames to Git state
 	TArray<FGitSourceControlState> States;
+
+	/** Files locally modified or claimed, that incoming commits should not change (absolute filenames) */
+	TSet<FString> LocalChanges;
+
+	/** Abort instead of only reporting forecast conflicts */
+	bool bAbortOnConflictForecast = true;
 };
 
 /** Get source control status of files on local working copy. */
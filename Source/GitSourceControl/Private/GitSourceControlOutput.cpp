@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlOutput.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+#if PLATFORM_ALWAYS_HAS_AVX_2
+#include <immintrin.h>
+#endif
+
+/** Call a function with the index of each separator in a range of bytes, scanning blocks of 32 or 16 bytes at once where possible */
+template<typename FunctionType>
+static void ForEachSeparator(const UTF8CHAR* InBytes, int32 InStart, int32 InEnd, UTF8CHAR InSeparator, FunctionType&& InFunction)
+{
+	int32 Index = InStart;
+#if PLATFORM_ALWAYS_HAS_AVX_2
+	const __m256i Separators32 = _mm256_set1_epi8((char)InSeparator);
+	for(; Index + 32 <= InEnd; Index += 32)
+	{
+		const __m256i Block = _mm256_loadu_si256((const __m256i*)(InBytes + Index));
+		uint32 Mask = (uint32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(Block, Separators32));
+		while(Mask != 0)
+		{
+			InFunction(Index + (int32)FMath::CountTrailingZeros(Mask));
+			Mask &= Mask - 1;
+		}
+	}
+#endif
+#if PLATFORM_CPU_X86_FAMILY
+	const __m128i Separators16 = _mm_set1_epi8((char)InSeparator);
+	for(; Index + 16 <= InEnd; Index += 16)
+	{
+		const __m128i Block = _mm_loadu_si128((const __m128i*)(InBytes + Index));
+		uint32 Mask = (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(Block, Separators16));
+		while(Mask != 0)
+		{
+			InFunction(Index + (int32)FMath::CountTrailingZeros(Mask));
+			Mask &= Mask - 1;
+		}
+	}
+#endif
+	for(; Index < InEnd; Index++)
+	{
+		if(InBytes[Index] == InSeparator)
+		{
+			InFunction(Index);
+		}
+	}
+}
+
+void FGitOutput::Append(TConstArrayView<uint8> InBytes)
+{
+	if(InBytes.Num() == 0)
+	{
+		return;
+	}
+	if(Bytes.Num() > 0)
+	{
+		// the terminating NUL
+		Bytes.Pop(EAllowShrinking::No);
+	}
+	Bytes.Append((const UTF8CHAR*)InBytes.GetData(), InBytes.Num());
+	Bytes.Add(UTF8CHAR(0));
+}
+
+void FGitOutput::Split(EGitRecordSeparator InSeparator)
+{
+	const int32 End = FMath::Max(0, Bytes.Num() - 1);
+	const bool bLines = InSeparator == EGitRecordSeparator::NewLine;
+	auto AddRecord = [this, bLines](int32 InStart, int32 InEnd)
+	{
+		if(bLines)
+		{
+			if(InEnd > InStart && Bytes[InEnd - 1] == UTF8CHAR('\r'))
+			{
+				InEnd--;
+			}
+			if(InEnd == InStart)
+			{
+				return;
+			}
+		}
+		Records.Add({InStart, InEnd - InStart});
+	};
+
+	int32 RecordStart = SplitOffset;
+	ForEachSeparator(Bytes.GetData(), SplitOffset, End, bLines ? UTF8CHAR('\n') : UTF8CHAR(0), [&AddRecord, &RecordStart](int32 InSeparatorIndex)
+	{
+		AddRecord(RecordStart, InSeparatorIndex);
+		RecordStart = InSeparatorIndex + 1;
+	});
+	if(RecordStart < End)
+	{
+		AddRecord(RecordStart, End);
+	}
+	SplitOffset = End;
+}
+
+void FGitOutput::Reset()
+{
+	Bytes.Reset();
+	Records.Reset();
+	SplitOffset = 0;
+}
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** How the records of an output are terminated */
+enum class EGitRecordSeparator : uint8
+{
+	/** Lines; carriage returns before line feeds and empty lines are dropped */
+	NewLine,
+	/** NUL terminated entries of the "-z" formats */
+	Nul,
+};
+
+/**
+ * Standard output of a command kept as the raw UTF-8 bytes written by the process, split into records.
+ *
+ * Records are found with vectorized scans of the bytes (AVX2 where the platform always has it, SSE2 on x86, scalar elsewhere)
+ * and handed out as views into the buffer, valid as long as the output: parsers only convert to FString the fields they store.
+ * The bytes are always followed by a NUL, so that a record can be read by C string functions that stop at a delimiter.
+ */
+class FGitOutput
+{
+public:
+	/** Append bytes read from the process */
+	void Append(TConstArrayView<uint8> InBytes);
+
+	/** Split the bytes appended since the last call into records (a last record without separator is kept) */
+	void Split(EGitRecordSeparator InSeparator = EGitRecordSeparator::NewLine);
+
+	/** Forget the bytes and records, keeping the memory */
+	void Reset();
+
+	int32 Num() const
+	{
+		return Records.Num();
+	}
+
+	bool IsEmpty() const
+	{
+		return Records.Num() == 0;
+	}
+
+	FUtf8StringView operator[](int32 InIndex) const
+	{
+		const FRecord& Record = Records[InIndex];
+		return FUtf8StringView(Bytes.GetData() + Record.Start, Record.Len);
+	}
+
+	/** Index of the first record matching a predicate, INDEX_NONE if none */
+	template<typename PredicateType>
+	int32 IndexOfByPredicate(PredicateType InPredicate) const
+	{
+		for(int32 Index = 0; Index < Records.Num(); Index++)
+		{
+			if(InPredicate((*this)[Index]))
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+private:
+	struct FRecord
+	{
+		int32 Start;
+		int32 Len;
+	};
+
+	/** Raw bytes, followed by a NUL */
+	TArray<UTF8CHAR> Bytes;
+
+	/** Records as offsets, so that they survive the growth of the bytes */
+	TArray<FRecord> Records;
+
+	/** Bytes before this offset are already split */
+	int32 SplitOffset = 0;
+};
+
+namespace GitSourceControlOutput
+{
+
+/** Copy a field to store it */
+inline FString ToString(FUtf8StringView InField)
+{
+	return FString(InField.Len(), InField.GetData());
+}
+
+inline FString ToString(FStringView InField)
+{
+	return FString(InField);
+}
+
+}
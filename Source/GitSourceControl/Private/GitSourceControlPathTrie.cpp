@@ -0,0 +1,232 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlPathTrie.h"
+
+ECommitSpread FGitFolderStatus::GetFolderSpread() const
+{
+	// a single flag each, picked for its predicates (see GitSpreadPredicates::Compute)
+	if(HasOtherClaims())
+	{
+		return ECommitSpread::CloneUncommitted;
+	}
+	if(Num(EGitStateIndex::CheckedOut) > 0)
+	{
+		return HasLocalChanges() ? ECommitSpread::LocalUncommitted : ECommitSpread::LocalActiveBranch;
+	}
+	if(Num(EGitStateIndex::NotCurrent) > 0)
+	{
+		return ECommitSpread::RemoteMatchingBranch;
+	}
+	return ECommitSpread::Unknown;
+}
+
+FGitSourceControlPathTrie::FGitSourceControlPathTrie()
+{
+	Nodes.AddDefaulted();
+}
+
+void FGitSourceControlPathTrie::Count(FGitFolderStatus& InOutStatus, EGitStateIndex InIndices, ECommitSpread InSpread, int32 InDelta)
+{
+	for(int32 Bit = 0; Bit < 8; Bit++)
+	{
+		if((uint8)InIndices & (1 << Bit))
+		{
+			InOutStatus.IndexCounts[Bit] += InDelta;
+		}
+		if((uint8)InSpread & (1 << Bit))
+		{
+			InOutStatus.SpreadCounts[Bit] += InDelta;
+		}
+	}
+}
+
+void FGitSourceControlPathTrie::FindOrAddChain(const FString& InFilename, TArray<int32, TInlineAllocator<32>>& OutChain, FString& OutCleanFilename)
+{
+	int32 Node = 0;
+	OutChain.Add(Node);
+	int32 Start = 0;
+	int32 End = INDEX_NONE;
+	while((End = InFilename.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Start)) != INDEX_NONE)
+	{
+		if(End > Start)
+		{
+			const FString Name = InFilename.Mid(Start, End - Start);
+			int32 Child;
+			if(const int32* FoundChild = Nodes[Node].Children.Find(Name))
+			{
+				Child = *FoundChild;
+			}
+			else
+			{
+				Child = Nodes.AddDefaulted();
+				Nodes[Child].Path = InFilename.Left(End);
+				Nodes[Node].Children.Add(Name, Child);
+			}
+			Node = Child;
+			OutChain.Add(Node);
+		}
+		Start = End + 1;
+	}
+	OutCleanFilename = InFilename.Mid(Start);
+}
+
+int32 FGitSourceControlPathTrie::FindNode(FStringView InDirectory) const
+{
+	int32 Node = 0;
+	int32 Start = 0;
+	while(Start < InDirectory.Len())
+	{
+		int32 End = Start;
+		while(End < InDirectory.Len() && InDirectory[End] != TEXT('/'))
+		{
+			End++;
+		}
+		if(End > Start)
+		{
+			const int32* Child = Nodes[Node].Children.Find(FString(InDirectory.Mid(Start, End - Start)));
+			if(Child == nullptr)
+			{
+				return INDEX_NONE;
+			}
+			Node = *Child;
+		}
+		Start = End + 1;
+	}
+	return Node;
+}
+
+void FGitSourceControlPathTrie::Add(const FString& InFilename, EGitStateIndex InIndices, ECommitSpread InSpread)
+{
+	FWriteScopeLock WriteLock(Lock);
+	TArray<int32, TInlineAllocator<32>> Chain;
+	FString CleanFilename;
+	FindOrAddChain(InFilename, Chain, CleanFilename);
+	for(const int32 Node : Chain)
+	{
+		Nodes[Node].Status.NumFiles++;
+		Count(Nodes[Node].Status, InIndices, InSpread, 1);
+	}
+	if(InIndices != EGitStateIndex::None)
+	{
+		Nodes[Chain.Last()].IndexedFiles.Add(MoveTemp(CleanFilename), InIndices);
+	}
+}
+
+void FGitSourceControlPathTrie::Update(const FString& InFilename, EGitStateIndex InOldIndices, ECommitSpread InOldSpread, EGitStateIndex InNewIndices, ECommitSpread InNewSpread)
+{
+	if(InOldIndices == InNewIndices && InOldSpread == InNewSpread)
+	{
+		return;
+	}
+	FWriteScopeLock WriteLock(Lock);
+	TArray<int32, TInlineAllocator<32>> Chain;
+	FString CleanFilename;
+	FindOrAddChain(InFilename, Chain, CleanFilename);
+	for(const int32 Node : Chain)
+	{
+		Count(Nodes[Node].Status, InOldIndices, InOldSpread, -1);
+		Count(Nodes[Node].Status, InNewIndices, InNewSpread, 1);
+	}
+	if(InNewIndices != EGitStateIndex::None)
+	{
+		Nodes[Chain.Last()].IndexedFiles.Add(MoveTemp(CleanFilename), InNewIndices);
+	}
+	else if(InOldIndices != EGitStateIndex::None)
+	{
+		Nodes[Chain.Last()].IndexedFiles.Remove(CleanFilename);
+	}
+}
+
+void FGitSourceControlPathTrie::Remove(const FString& InFilename, EGitStateIndex InIndices, ECommitSpread InSpread)
+{
+	FWriteScopeLock WriteLock(Lock);
+	TArray<int32, TInlineAllocator<32>> Chain;
+	FString CleanFilename;
+	FindOrAddChain(InFilename, Chain, CleanFilename);
+	for(const int32 Node : Chain)
+	{
+		Nodes[Node].Status.NumFiles--;
+		Count(Nodes[Node].Status, InIndices, InSpread, -1);
+	}
+	if(InIndices != EGitStateIndex::None)
+	{
+		Nodes[Chain.Last()].IndexedFiles.Remove(CleanFilename);
+	}
+}
+
+void FGitSourceControlPathTrie::Empty()
+{
+	FWriteScopeLock WriteLock(Lock);
+	Nodes.Empty();
+	Nodes.AddDefaulted();
+}
+
+bool FGitSourceControlPathTrie::GetFolderStatus(const FString& InDirectory, FGitFolderStatus& OutStatus) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const int32 Node = FindNode(InDirectory);
+	if(Node == INDEX_NONE || Nodes[Node].Status.NumFiles == 0)
+	{
+		return false;
+	}
+	OutStatus = Nodes[Node].Status;
+	return true;
+}
+
+void FGitSourceControlPathTrie::GetFiles(const FString& InDirectory, EGitStateIndex InIndices, bool bInRecursive, TArray<FString>& OutFiles) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const int32 Node = FindNode(InDirectory);
+	if(Node != INDEX_NONE)
+	{
+		GetFilesInternal(Node, InIndices, bInRecursive, OutFiles);
+	}
+}
+
+void FGitSourceControlPathTrie::GetFilesInternal(int32 InNode, EGitStateIndex InIndices, bool bInRecursive, TArray<FString>& OutFiles) const
+{
+	const FNode& Node = Nodes[InNode];
+	for(const auto& File : Node.IndexedFiles)
+	{
+		if(EnumHasAnyFlags(File.Value, InIndices))
+		{
+			OutFiles.Add(Node.Path / File.Key);
+		}
+	}
+	if(!bInRecursive)
+	{
+		return;
+	}
+	for(const auto& Child : Node.Children)
+	{
+		// only walk down folders that have some of the requested files
+		const FGitFolderStatus& Status = Nodes[Child.Value].Status;
+		for(int32 Bit = 0; Bit < 8; Bit++)
+		{
+			if(((uint8)InIndices & (1 << Bit)) && Status.IndexCounts[Bit] > 0)
+			{
+				GetFilesInternal(Child.Value, InIndices, bInRecursive, OutFiles);
+				break;
+			}
+		}
+	}
+}
+
+SIZE_T FGitSourceControlPathTrie::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+	SIZE_T Size = Nodes.GetAllocatedSize();
+	for(const FNode& Node : Nodes)
+	{
+		Size += Node.Path.GetAllocatedSize() + Node.Children.GetAllocatedSize() + Node.IndexedFiles.GetAllocatedSize();
+		for(const auto& Child : Node.Children)
+		{
+			Size += Child.Key.GetAllocatedSize();
+		}
+		for(const auto& File : Node.IndexedFiles)
+		{
+			Size += File.Key.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "GitSourceControlState.h"
+
+/** Aggregated states of the cached files below a folder */
+struct FGitFolderStatus
+{
+	/** Number of cached files */
+	int32 NumFiles = 0;
+
+	/** Number of files in each index of the state cache, by bit of EGitStateIndex */
+	int32 IndexCounts[8] = {};
+
+	/** Number of files with each spread flag, by bit of ECommitSpread */
+	int32 SpreadCounts[8] = {};
+
+	/** Number of files in an index (a single flag) */
+	int32 Num(EGitStateIndex InIndex) const
+	{
+		return IndexCounts[FMath::FloorLog2((uint32)InIndex)];
+	}
+
+	/** Number of files with a spread flag (a single flag) */
+	int32 Num(ECommitSpread InSpread) const
+	{
+		return SpreadCounts[FMath::FloorLog2((uint32)InSpread)];
+	}
+
+	/**
+	 * Spread of a state standing for the folder, built from the index counts since the predicates of a spread depend on exact combinations of flags:
+	 * checked out by another clone if any file is, else checked out if any file is, else not current if any file is.
+	 */
+	ECommitSpread GetFolderSpread() const;
+
+	bool HasLocalChanges() const
+	{
+		return Num(EGitStateIndex::Modified) > 0;
+	}
+
+	bool HasOtherClaims() const
+	{
+		return Num(EGitStateIndex::CheckedOutOther) > 0;
+	}
+};
+
+/**
+ * Trie of the folders of the cached files, mirroring the directories of the repository.
+ *
+ * Each folder aggregates counters of the files below it per index and spread flag, updated in O(depth) when a file changes,
+ * so that folder level questions (any local change or claim of another clone under a folder?) never scan the cache.
+ * Folders also list their own files that are in any index, to enumerate changed files of a folder by walking only the folders that have some.
+ * All methods are thread safe.
+ */
+class FGitSourceControlPathTrie
+{
+public:
+	FGitSourceControlPathTrie();
+
+	/** Count a new file, with its indices and spread */
+	void Add(const FString& InFilename, EGitStateIndex InIndices, ECommitSpread InSpread);
+
+	/** Move a file from its previous indices and spread to new ones */
+	void Update(const FString& InFilename, EGitStateIndex InOldIndices, ECommitSpread InOldSpread, EGitStateIndex InNewIndices, ECommitSpread InNewSpread);
+
+	/** Stop counting a file, with its current indices and spread */
+	void Remove(const FString& InFilename, EGitStateIndex InIndices, ECommitSpread InSpread);
+
+	/** Forget all folders */
+	void Empty();
+
+	/** Get the aggregated states of the files below a folder; returns false if no cached file is below it */
+	bool GetFolderStatus(const FString& InDirectory, FGitFolderStatus& OutStatus) const;
+
+	/** Files of a folder (and of its subfolders if recursive) that are in any of the provided indices */
+	void GetFiles(const FString& InDirectory, EGitStateIndex InIndices, bool bInRecursive, TArray<FString>& OutFiles) const;
+
+	/** Memory used by the folders */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FNode
+	{
+		/** Absolute path of the folder */
+		FString Path;
+
+		/** Subfolders by name */
+		TMap<FString, int32> Children;
+
+		/** Files of this folder in any index, by clean filename */
+		TMap<FString, EGitStateIndex> IndexedFiles;
+
+		FGitFolderStatus Status;
+	};
+
+	/** Add or subtract a file to the counters of a folder */
+	static void Count(FGitFolderStatus& InOutStatus, EGitStateIndex InIndices, ECommitSpread InSpread, int32 InDelta);
+
+	/** Find the folder of a path, INDEX_NONE if unknown */
+	int32 FindNode(FStringView InDirectory) const;
+
+	/** Get the folders from the root to the folder of a file, creating missing ones, and the clean filename (write lock held) */
+	void FindOrAddChain(const FString& InFilename, TArray<int32, TInlineAllocator<32>>& OutChain, FString& OutCleanFilename);
+
+	/** Collect the indexed files of a folder and, if recursive, of its subfolders (read lock held) */
+	void GetFilesInternal(int32 InNode, EGitStateIndex InIndices, bool bInRecursive, TArray<FString>& OutFiles) const;
+
+	/** Folders, the root (above any drive or leading slash) first */
+	TArray<FNode> Nodes;
+
+	mutable FRWLock Lock;
+};
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlPermissions.h"
+
+#include <atomic>
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "GitSourceControlState.h"
+
+namespace GitPermissionsConstants
+{
+	/** Number of files checked by each task */
+	const int32 BatchSize = 256;
+}
+
+bool FGitSourceControlPermissionManager::ShouldBeWritable(const FGitSourceControlState& InState)
+{
+	// Our own changes, and files Git does not track, always stay writable
+	if(InState.IsCheckedOut() || InState.IsModified() || InState.IsAdded() || !InState.IsSourceControlled())
+	{
+		return true;
+	}
+	// Files changed or claimed elsewhere are not safe to edit
+	return InState.CanEdit() && !InState.IsCheckedOutOther();
+}
+
+void FGitSourceControlPermissionManager::Apply(const TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>>& InStates)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Gather targets from the published states
+	TArray<TPair<FString, bool>> Targets;
+	Targets.Reserve(InStates.Num());
+	for(const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& State : InStates)
+	{
+		if(!State->IsDeleted() && State->WorkingCopyState != EWorkingCopyState::Missing)
+		{
+			Targets.Emplace(State->LocalFilename, ShouldBeWritable(*State));
+		}
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	std::atomic<int32> ChangedFiles(0);
+	const int32 NumBatches = FMath::DivideAndRoundUp(Targets.Num(), GitPermissionsConstants::BatchSize);
+	ParallelFor(NumBatches, [&Targets, &PlatformFile, &ChangedFiles](int32 BatchIndex)
+	{
+		const int32 Start = BatchIndex * GitPermissionsConstants::BatchSize;
+		const int32 End = FMath::Min(Start + GitPermissionsConstants::BatchSize, Targets.Num());
+		for(int32 Index = Start; Index < End; Index++)
+		{
+			const FString& Filename = Targets[Index].Key;
+			const bool bWritable = Targets[Index].Value;
+			if(PlatformFile.IsReadOnly(*Filename) == bWritable && PlatformFile.FileExists(*Filename))
+			{
+				if(PlatformFile.SetReadOnly(*Filename, !bWritable))
+				{
+					ChangedFiles++;
+				}
+				else
+				{
+					UE_LOG(LogSourceControl, Warning, TEXT("Permissions: cannot make '%s' %s"), *Filename, bWritable ? TEXT("writable") : TEXT("read-only"));
+				}
+			}
+		}
+	});
+
+	const int32 NumChangedFiles = ChangedFiles;
+	const double Duration = FPlatformTime::Seconds() - StartTime;
+	LastChangedFiles.store(NumChangedFiles, std::memory_order_relaxed);
+	LastDuration.store(Duration, std::memory_order_relaxed);
+	UE_LOG(LogSourceControl, Log, TEXT("Permissions: %d/%d file(s) changed in %.3lfs"), NumChangedFiles, Targets.Num(), Duration);
+}
@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+class FGitSourceControlState;
+
+/**
+ * Keep the read-only flag of files in line with their state when Gitalong is set to modify permissions.
+ *
+ * Files changed or claimed elsewhere are made read-only, others writable.
+ * Changes are applied in parallel batches, touching only files whose mode actually differs,
+ * instead of delegating the whole repository to a Gitalong process after each status change.
+ * Apply() runs on whichever thread publishes the states, possibly several at once: the statistics of the last pass are atomic.
+ */
+class FGitSourceControlPermissionManager
+{
+public:
+	/** Should this file be writable */
+	static bool ShouldBeWritable(const FGitSourceControlState& InState);
+
+	/** Apply the permissions of these states to their files. Called from the thread publishing the states. */
+	void Apply(const TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>>& InStates);
+
+	/** Number of files changed and duration in seconds of the last Apply() */
+	int32 GetLastChangedFiles() const
+	{
+		return LastChangedFiles.load(std::memory_order_relaxed);
+	}
+
+	double GetLastDuration() const
+	{
+		return LastDuration.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<int32> LastChangedFiles{0};
+	std::atomic<double> LastDuration{0.0};
+};
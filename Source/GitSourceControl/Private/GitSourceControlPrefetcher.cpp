@@ -0,0 +1,165 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlPrefetcher.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "ContentBrowserModule.h"
+#include "Editor.h"
+#include "Misc/PackageName.h"
+#include "Modules/ModuleManager.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "GitSourceControlModule.h"
+
+namespace GitPrefetchConstants
+{
+	/** Minimum delay between two flushes, so that a burst of selection changes ends up in a single query */
+	const double FlushInterval = 0.25;
+
+	/** Do not prefetch the same package again before this delay */
+	const double RefreshInterval = 30.0;
+
+	/** The maximum number of files we prefetch in a single query */
+	const int32 MaxFilesPerPrefetch = 500;
+}
+
+void FGitSourceControlPrefetcher::TryRegister()
+{
+	if(!AssetOpenedInEditorHandle.IsValid() && GEditor != nullptr)
+	{
+		if(UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+		{
+			AssetOpenedInEditorHandle = AssetEditorSubsystem->OnAssetOpenedInEditor().AddRaw(this, &FGitSourceControlPrefetcher::OnAssetOpenedInEditor);
+		}
+	}
+	if(!AssetSelectionChangedHandle.IsValid() && FModuleManager::Get().IsModuleLoaded("ContentBrowser"))
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::GetModuleChecked<FContentBrowserModule>("ContentBrowser");
+		AssetSelectionChangedHandle = ContentBrowserModule.GetOnAssetSelectionChanged().AddRaw(this, &FGitSourceControlPrefetcher::OnAssetSelectionChanged);
+	}
+}
+
+void FGitSourceControlPrefetcher::Unregister()
+{
+	if(AssetOpenedInEditorHandle.IsValid())
+	{
+		if(GEditor != nullptr)
+		{
+			if(UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+			{
+				AssetEditorSubsystem->OnAssetOpenedInEditor().Remove(AssetOpenedInEditorHandle);
+			}
+		}
+		AssetOpenedInEditorHandle.Reset();
+	}
+	if(AssetSelectionChangedHandle.IsValid())
+	{
+		if(FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>("ContentBrowser"))
+		{
+			ContentBrowserModule->GetOnAssetSelectionChanged().Remove(AssetSelectionChangedHandle);
+		}
+		AssetSelectionChangedHandle.Reset();
+	}
+	PendingPackages.Empty();
+	LastPrefetchTimes.Empty();
+}
+
+void FGitSourceControlPrefetcher::Tick()
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if(!GitSourceControl.AccessSettings().IsStatusPrefetchEnabled() || !GitSourceControl.GetProvider().IsEnabled())
+	{
+		return;
+	}
+
+	TryRegister();
+
+	const double Now = FPlatformTime::Seconds();
+	if(PendingPackages.Num() > 0 && !bPrefetchInFlight && (Now - LastFlushTime) >= GitPrefetchConstants::FlushInterval)
+	{
+		LastFlushTime = Now;
+		Flush();
+	}
+}
+
+void FGitSourceControlPrefetcher::OnAssetOpenedInEditor(UObject* InAsset, IAssetEditorInstance* InEditorInstance)
+{
+	if(InAsset != nullptr && InAsset->GetPackage() != nullptr)
+	{
+		QueuePackage(InAsset->GetPackage()->GetFName(), true);
+	}
+}
+
+void FGitSourceControlPrefetcher::OnAssetSelectionChanged(const TArray<FAssetData>& InSelectedAssets, bool bInIsPrimaryBrowser)
+{
+	for(const FAssetData& AssetData : InSelectedAssets)
+	{
+		QueuePackage(AssetData.PackageName, true);
+	}
+}
+
+void FGitSourceControlPrefetcher::QueuePackage(const FName& InPackageName, bool bInWithDependencies)
+{
+	if(InPackageName.IsNone() || FPackageName::IsScriptPackage(InPackageName.ToString()))
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double* LastPrefetchTime = LastPrefetchTimes.Find(InPackageName);
+	if(LastPrefetchTime == nullptr || (Now - *LastPrefetchTime) >= GitPrefetchConstants::RefreshInterval)
+	{
+		PendingPackages.Add(InPackageName);
+	}
+
+	if(bInWithDependencies)
+	{
+		if(IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+		{
+			TArray<FName> Dependencies;
+			AssetRegistry->GetDependencies(InPackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package);
+			for(const FName& Dependency : Dependencies)
+			{
+				QueuePackage(Dependency, false);
+			}
+		}
+	}
+}
+
+void FGitSourceControlPrefetcher::Flush()
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+	const FString& PathToRepositoryRoot = Provider.GetPathToRepositoryRoot();
+
+	const double Now = FPlatformTime::Seconds();
+	TArray<FString> Files;
+	for(auto It = PendingPackages.CreateIterator(); It && Files.Num() < GitPrefetchConstants::MaxFilesPerPrefetch; ++It)
+	{
+		// Only prefetch existing files of our own repository (skip Engine and not yet saved packages)
+		const FString Filename = SourceControlHelpers::PackageFilename(It->ToString());
+		if(Filename.StartsWith(PathToRepositoryRoot) && FPaths::FileExists(Filename))
+		{
+			Files.Add(Filename);
+		}
+		LastPrefetchTimes.Add(*It, Now);
+		It.RemoveCurrent();
+	}
+
+	if(Files.Num() > 0)
+	{
+		UE_LOG(LogSourceControl, Verbose, TEXT("Prefetching status of %d file(s)"), Files.Num());
+		bPrefetchInFlight = true;
+		const ECommandResult::Type Result = Provider.Execute(ISourceControlOperation::Create<FUpdateStatus>(), Files, EConcurrency::Asynchronous, FSourceControlOperationComplete::CreateRaw(this, &FGitSourceControlPrefetcher::OnPrefetchComplete));
+		if(Result != ECommandResult::Succeeded)
+		{
+			bPrefetchInFlight = false;
+		}
+	}
+}
+
+void FGitSourceControlPrefetcher::OnPrefetchComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
+{
+	bPrefetchInFlight = false;
+}
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ISourceControlProvider.h"
+
+struct FAssetData;
+class IAssetEditorInstance;
+
+/**
+ * Speculatively refresh the status of assets the user is about to work on.
+ *
+ * Listen to assets being opened in an editor and to Content Browser selection changes,
+ * and gather the packages (and their immediate dependencies) in order to issue one batched
+ * background "UpdateStatus" per flush, so that Gitalong spread information is already fresh
+ * when the user starts modifying something.
+ */
+class FGitSourceControlPrefetcher
+{
+public:
+	/** Stop listening to Editor events */
+	void Unregister();
+
+	/** Register to Editor events when available, and flush gathered packages. This is always executed on the main thread. */
+	void Tick();
+
+private:
+	/** Register to Editor events that are available (the Editor and Content Browser may come up after the provider) */
+	void TryRegister();
+
+	/** Delegates for Editor events */
+	void OnAssetOpenedInEditor(UObject* InAsset, IAssetEditorInstance* InEditorInstance);
+	void OnAssetSelectionChanged(const TArray<FAssetData>& InSelectedAssets, bool bInIsPrimaryBrowser);
+
+	/** Gather a package, and optionally its immediate dependencies, for the next flush */
+	void QueuePackage(const FName& InPackageName, bool bInWithDependencies);
+
+	/** Issue a single background status update for all gathered packages */
+	void Flush();
+
+	/** Delegate called when the prefetch operation has completed */
+	void OnPrefetchComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
+
+	/** Packages gathered since the last flush */
+	TSet<FName> PendingPackages;
+
+	/** Last time each package was prefetched, to avoid querying the same assets over and over */
+	TMap<FName, double> LastPrefetchTimes;
+
+	/** Time of the last flush */
+	double LastFlushTime = 0.0;
+
+	/** Is a prefetch operation in flight */
+	bool bPrefetchInFlight = false;
+
+	FDelegateHandle AssetOpenedInEditorHandle;
+	FDelegateHandle AssetSelectionChangedHandle;
+};
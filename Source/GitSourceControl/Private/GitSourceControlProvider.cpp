@@ -3,10 +3,6 @@
 #include "GitSourceControlProvider.h"
 #include "GitSourceControlState.h"
 
-#include <cstdlib>
-#include <iostream>
-#include <memory>
-
 #include "HAL/PlatformProcess.h"
 #include "Misc/Paths.h"
 #include "Misc/QueuedThreadPool.h"
@@ -20,6 +16,8 @@
 #include "SGitSourceControlSettings.h"
 #include "SourceControlOperations.h"
 #include "Logging/MessageLog.h"
+#include "Async/Async.h"
+#include "Algo/AllOf.h"
 #include "ScopedSourceControlProgress.h"
 #include "UObject/ObjectSaveContext.h"
 
@@ -42,7 +40,47 @@ void FGitSourceControlProvider::Init(bool bForceConnection)
 
 	// bForceConnection: not used anymore
 
-	if(bGitalongAvailable)
+	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	// loaded once, even without a config file: the Directory Watcher then reports when one is created
+	if(bGitRepositoryFound && !GitalongConfig.IsLoadAttempted())
+	{
+		GitalongConfig.Load(PathToRepositoryRoot);
+	}
+
+	if(bGitRepositoryFound && GitSourceControl.AccessSettings().IsClaimStoreClientEnabled() && (!ClaimStore.IsConfigured() || GitalongConfigRevision != GitalongConfig.GetRevision()))
+	{
+		ConfigureClaimStore();
+	}
+
+	StateCache.SetHistoryBudget((int64)GitSourceControl.AccessSettings().GetHistoryBudgetMB() * 1024 * 1024);
+
+	// show the states of the last session right away, until the "Connect" operation validates them:
+	// only cached, permissions and claims are left to the validated states
+	if(bGitRepositoryFound && GitSourceControl.AccessSettings().IsStateSnapshotEnabled() && !Snapshot.IsLoaded() && StateCache.Num() == 0)
+	{
+		if(Snapshot.Load(FGitSourceControlSnapshot::GetDefaultFilename(), PathToRepositoryRoot))
+		{
+			for(const FGitSourceControlState& SnapshotState : Snapshot.GetStates())
+			{
+				StateCache.Update(SnapshotState.LocalFilename, [&SnapshotState](FGitSourceControlState& State)
+				{
+					State = SnapshotState;
+					return true;
+				});
+			}
+		}
+	}
+
+	if(bGitalongAvailable && bGitRepositoryFound && GitSourceControl.AccessSettings().IsClaimJournalEnabled())
+	{
+		if(ClaimJournal.IsRunning())
+		{
+			return;
+		}
+		ClaimJournal.Start(PathToGitalongBinary, PathToRepositoryRoot);
+		ClaimJournal.Append(TEXT("update"), TArray<FString>());
+	}
+	else if(bGitalongAvailable)
 	{
 		TArray<FString> InResults;
 		TArray<FString> InFiles;
@@ -121,6 +159,8 @@ void FGitSourceControlProvider::CheckRepositoryStatus(const FString& InPathToGit
 		if(bGitRepositoryFound)
 		{
 			GitSourceControlUtils::GetRemoteUrl(InPathToGitBinary, PathToRepositoryRoot, RemoteUrl);
+			// cached files are keyed by their path relative to the root
+			StateCache.SetRepositoryRoot(PathToRepositoryRoot);
 		}
 		else
 		{
@@ -136,10 +176,50 @@ void FGitSourceControlProvider::CheckRepositoryStatus(const FString& InPathToGit
 	GitSourceControlUtils::GetUserConfig(InPathToGitBinary, PathToRepositoryRoot, UserName, UserEmail);
 }
 
+void FGitSourceControlProvider::ConfigureClaimStore()
+{
+	GitalongConfigRevision = GitalongConfig.GetRevision();
+	ClaimSubscription.Disconnect();
+
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if(ClaimStore.Configure(GitalongConfig) && GitSourceControl.AccessSettings().IsClaimSubscriptionEnabled())
+	{
+		ClaimSubscription.Connect(PathToRepositoryRoot, GitalongConfig.GetRelayUrl(), GitalongConfig.GetStoreHeaders());
+	}
+}
+
 void FGitSourceControlProvider::Close()
 {
+	// stop listening to the Editor
+	Prefetcher.Unregister();
+
+	// stop listening to claim changes
+	ClaimSubscription.Disconnect();
+
+	// stop replaying Gitalong commands (the journal file keeps what is left for the next session)
+	ClaimJournal.Shutdown();
+
+	// save the states for the next session, once any periodic save is done
+	if(SnapshotSaveTask.IsValid())
+	{
+		SnapshotSaveTask.Wait();
+		SnapshotSaveTask.Reset();
+	}
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	if(bGitRepositoryFound && GitSourceControl.AccessSettings().IsStateSnapshotEnabled() && StateCache.Num() > 0)
+	{
+		SaveSnapshot(false);
+	}
+	Snapshot.Reset();
+
 	// clear the cache
 	StateCache.Empty();
+	CommitTable.Empty();
+	PendingStateDelta.Empty();
+	ClaimIndex.Reset();
+	SpreadEngine.Reset();
+	ClaimStore.Reset();
+	GitalongConfig.Reset();
 
 	bGitAvailable = false;
 	bGitRepositoryFound = false;
@@ -149,19 +229,13 @@ void FGitSourceControlProvider::Close()
 
 TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::GetStateInternal(const FString& Filename)
 {
-	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = StateCache.Find(Filename);
-	if(State != NULL)
-	{
-		// found cached item
-		return (*State);
-	}
-	else
-	{
-		// cache an unknown state for this item
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> NewState = MakeShareable( new FGitSourceControlState(Filename) );
-		StateCache.Add(Filename, NewState);
-		return NewState;
-	}
+	// found cached item, or cache an unknown state for this item
+	return StateCache.FindOrAdd(Filename);
+}
+
+TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::FindStateInternal(const FString& Filename) const
+{
+	return StateCache.Find(Filename);
 }
 
 FText FGitSourceControlProvider::GetStatusText() const
@@ -213,15 +287,41 @@ ECommandResult::Type FGitSourceControlProvider::GetState( const TArray<FString>&
 		return ECommandResult::Failed;
 	}
 
-	TArray<FString> AbsoluteFiles = SourceControlHelpers::AbsoluteFilenames(InFiles);
+	// files given as normalized absolute paths (the common case) are looked up as is, without copying the list
+	TArray<FString> AbsoluteFiles;
+	const bool bNormalized = Algo::AllOf(InFiles, [this](const FString& File) { return StateCache.IsNormalized(File); });
+	if(!bNormalized || InStateCacheUsage == EStateCacheUsage::ForceUpdate)
+	{
+		AbsoluteFiles = SourceControlHelpers::AbsoluteFilenames(InFiles);
+	}
+	const TArray<FString>& Files = bNormalized ? InFiles : AbsoluteFiles;
 
 	if(InStateCacheUsage == EStateCacheUsage::ForceUpdate)
 	{
 		Execute(ISourceControlOperation::Create<FUpdateStatus>(), AbsoluteFiles);
 	}
 
-	for(const auto& AbsoluteFile : AbsoluteFiles)
+	TArray<FGitSourceControlStateCache::FStatePtr> States;
+	StateCache.Find(Files, States);
+	OutState.Reserve(OutState.Num() + Files.Num());
+	for(int32 Index = 0; Index < Files.Num(); Index++)
 	{
+		const FString& AbsoluteFile = Files[Index];
+		if(States[Index].IsValid())
+		{
+			OutState.Add(States[Index].ToSharedRef());
+			continue;
+		}
+		// folders are not cached: their state (for badges) aggregates the states of the files below them
+		FGitFolderStatus FolderStatus;
+		if(StateCache.GetPathTrie().GetFolderStatus(AbsoluteFile, FolderStatus))
+		{
+			TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FolderState = MakeShared<FGitSourceControlState, ESPMode::ThreadSafe>(AbsoluteFile);
+			FolderState->WorkingCopyState = FolderStatus.HasLocalChanges() ? EWorkingCopyState::Modified : EWorkingCopyState::Unchanged;
+			FolderState->LastCommitSpread = FolderStatus.GetFolderSpread();
+			OutState.Add(FolderState);
+			continue;
+		}
 		OutState.Add(GetStateInternal(*AbsoluteFile));
 	}
 
@@ -236,20 +336,34 @@ ECommandResult::Type FGitSourceControlProvider::GetState(const TArray<FSourceCon
 TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStateByPredicate(TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const
 {
 	TArray<FSourceControlStateRef> Result;
-	for(const auto& CacheItem : StateCache)
+	StateCache.ForEach([&Predicate, &Result](const FGitSourceControlStateCache::FStateRef& CachedState)
 	{
-		FSourceControlStateRef State = CacheItem.Value;
+		FSourceControlStateRef State = CachedState;
 		if(Predicate(State))
 		{
 			Result.Add(State);
 		}
-	}
+	});
+	return Result;
+}
+
+TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStateByPredicate(EGitStateIndex InIndices, TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const
+{
+	TArray<FSourceControlStateRef> Result;
+	StateCache.ForEach(InIndices, [&Predicate, &Result](const FGitSourceControlStateCache::FStateRef& CachedState)
+	{
+		FSourceControlStateRef State = CachedState;
+		if(Predicate(State))
+		{
+			Result.Add(State);
+		}
+	});
 	return Result;
 }
 
 bool FGitSourceControlProvider::RemoveFileFromCache(const FString& Filename)
 {
-	return StateCache.Remove(Filename) > 0;
+	return StateCache.Remove(Filename);
 }
 
 FDelegateHandle FGitSourceControlProvider::RegisterSourceControlStateChanged_Handle( const FSourceControlStateChanged::FDelegate& SourceControlStateChanged )
@@ -262,6 +376,16 @@ void FGitSourceControlProvider::UnregisterSourceControlStateChanged_Handle( FDel
 	OnSourceControlStateChanged.Remove( Handle );
 }
 
+FDelegateHandle FGitSourceControlProvider::RegisterStateDelta_Handle(const FGitSourceControlStateDeltaDelegate::FDelegate& InStateDelta)
+{
+	return OnStateDelta.Add(InStateDelta);
+}
+
+void FGitSourceControlProvider::UnregisterStateDelta_Handle(FDelegateHandle Handle)
+{
+	OnStateDelta.Remove(Handle);
+}
+
 ECommandResult::Type FGitSourceControlProvider::Execute( const FSourceControlOperationRef& InOperation, FSourceControlChangelistPtr InChangelist, const TArray<FString>& InFiles, EConcurrency::Type InConcurrency, const FSourceControlOperationComplete& InOperationCompleteDelegate )
 {
 	if(!IsEnabled() && !(InOperation->GetName() == "Connect")) // Only Connect operation allowed while not Enabled (Connected)
@@ -293,8 +417,14 @@ ECommandResult::Type FGitSourceControlProvider::Execute( const FSourceControlOpe
 	Command->Files = AbsoluteFiles;
 	Command->OperationCompleteDelegate = InOperationCompleteDelegate;
 
+	// let the worker look at (and possibly optimistically update) the cached states before the command is issued
+	if(Command->Worker->PrepareStates(*Command))
+	{
+		OnSourceControlStateChanged.Broadcast();
+	}
+
 	// fire off operation
-	if(InConcurrency == EConcurrency::Synchronous)
+	if(InConcurrency == EConcurrency::Synchronous && !Command->bOptimistic)
 	{
 		Command->bAutoDelete = false;
 		UE_LOG(LogSourceControl, Log, TEXT("ExecuteSynchronousCommand(%s)"), *InOperation->GetName().ToString());
@@ -303,7 +433,7 @@ ECommandResult::Type FGitSourceControlProvider::Execute( const FSourceControlOpe
 	else
 	{
 		Command->bAutoDelete = true;
-		UE_LOG(LogSourceControl, Log, TEXT("IssueAsynchronousCommand(%s)"), *InOperation->GetName().ToString());
+		UE_LOG(LogSourceControl, Log, TEXT("IssueAsynchronousCommand(%s)%s"), *InOperation->GetName().ToString(), Command->bOptimistic ? TEXT(" optimistic") : TEXT(""));
 		return IssueCommand(*Command);
 	}
 }
@@ -324,21 +454,8 @@ void FGitSourceControlProvider::CancelOperation( const FSourceControlOperationRe
 
 bool FGitSourceControlProvider::UsesLocalReadOnlyState() const
 {
-    std::string Output = "";
-#if PLATFORM_WINDOWS
-    //const std::shared_ptr<FILE> Pipe(_popen("gitalong config modify-permissions", "r"), _pclose);
-#else
-    const std::shared_ptr<FILE> Pipe(popen("gitalong config modify-permissions", "r"), pclose);
-#endif
-  //   if (Pipe)
-  //   {
-	 //    while (!feof(Pipe.get())) {
-	 //        if (char Buffer[128]; fgets(Buffer, 128, Pipe.get()) != nullptr)
-	 //            Output += Buffer;
-	 //    }
-		// return Output.find("true") != std::string::npos;
-  //   }
-	return false;
+	// Answered from the cached Gitalong config, since the Editor asks all the time
+	return GitalongConfig.ModifiesPermissions();
 }
 
 bool FGitSourceControlProvider::UsesChangelists() const
@@ -378,7 +495,11 @@ TOptional<bool> FGitSourceControlProvider::IsAtLatestRevision() const
 
 TOptional<int> FGitSourceControlProvider::GetNumLocalChanges() const
 {
-	return TOptional<int>();
+	if(!bGitRepositoryFound)
+	{
+		return TOptional<int>();
+	}
+	return StateCache.Num(EGitStateIndex::Modified);
 }
 
 TSharedPtr<IGitSourceControlWorker, ESPMode::ThreadSafe> FGitSourceControlProvider::CreateWorker(const FName& InOperationName) const
@@ -414,33 +535,60 @@ void FGitSourceControlProvider::OutputCommandMessages(const FGitSourceControlCom
 
 void FGitSourceControlProvider::Tick()
 {
-	bool bStatesUpdated = false;
-	for(int32 CommandIndex = 0; CommandIndex < CommandQueue.Num(); ++CommandIndex)
+	// including the states updated by synchronous commands since the last tick
+	bool bStatesUpdated = bStatesUpdatedPending;
+	bStatesUpdatedPending = false;
+
+	// Apply completed commands in the order they completed, within a time budget so that a burst of completions is spread over a few frames
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	const double Budget = GitSourceControl.AccessSettings().GetCommandTickBudgetMs() / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+	FGitSourceControlCommand* Command = nullptr;
+	while(CompletedCommands.Dequeue(Command))
 	{
-		FGitSourceControlCommand& Command = *CommandQueue[CommandIndex];
-		if(Command.bExecuteProcessed)
-		{
-			// Remove command from the queue
-			CommandQueue.RemoveAt(CommandIndex);
+		// let command update the states of any files
+		bStatesUpdated |= Command->Worker->UpdateStates();
+
+		// dump any messages to output log
+		OutputCommandMessages(*Command);
+
+		// the completion delegate may issue new commands: they are only queued here once completed
+		Command->ReturnResults();
+
+		// only auto deleted (asynchronous) commands go through this queue
+		delete Command;
 
-			// let command update the states of any files
-			bStatesUpdated |= Command.Worker->UpdateStates();
+		if((FPlatformTime::Seconds() - StartTime) > Budget)
+		{
+			break;
+		}
+	}
 
-			// dump any messages to output log
-			OutputCommandMessages(Command);
+	// apply a change of the claim store location in the Gitalong config
+	if(GitalongConfig.IsLoadAttempted() && GitalongConfigRevision != GitalongConfig.GetRevision() && GitSourceControl.AccessSettings().IsClaimStoreClientEnabled())
+	{
+		ConfigureClaimStore();
+	}
 
-			Command.ReturnResults();
+	// apply claim changes pushed by the relay
+	bStatesUpdated |= ClaimSubscription.Tick();
 
-			// commands that are left in the array during a tick need to be deleted
-			if(Command.bAutoDelete)
+	// states published by worker threads since the last tick
+	FGitSourceControlStateDelta StateDelta;
+	if(StateCache.ConsumeChanges(StateDelta))
+	{
+		bStatesUpdated = true;
+		bSnapshotDirty = true;
+		if(PendingStateDelta.Num() == 0)
+		{
+			PendingStateDelta = MoveTemp(StateDelta);
+		}
+		else
+		{
+			for(const auto& Change : StateDelta)
 			{
-				// Only delete commands that are not running 'synchronously'
-				delete &Command;
+				PendingStateDelta.FindOrAdd(Change.Key) |= Change.Value;
 			}
-
-			// only do one command per tick loop, as we dont want concurrent modification
-			// of the command queue (which can happen in the completion delegate)
-			break;
 		}
 	}
 
@@ -448,6 +596,49 @@ void FGitSourceControlProvider::Tick()
 	{
 		OnSourceControlStateChanged.Broadcast();
 	}
+
+	// tell delta listeners exactly which files changed, at a throttled rate
+	const double Now = FPlatformTime::Seconds();
+	if(PendingStateDelta.Num() > 0 && (Now - LastStateDeltaTime) * 1000.0 >= GitSourceControl.AccessSettings().GetStateDeltaIntervalMs())
+	{
+		LastStateDeltaTime = Now;
+		const FGitSourceControlStateDelta Delta = MoveTemp(PendingStateDelta);
+		PendingStateDelta.Reset();
+		OnStateDelta.Broadcast(Delta);
+	}
+
+	// save the states regularly, in case the Editor does not shut down cleanly
+	static constexpr double SnapshotIntervalSeconds = 300.0;
+	if(bSnapshotDirty && (Now - LastSnapshotTime) >= SnapshotIntervalSeconds && (!SnapshotSaveTask.IsValid() || SnapshotSaveTask.IsReady())
+		&& bGitRepositoryFound && GitSourceControl.AccessSettings().IsStateSnapshotEnabled())
+	{
+		SaveSnapshot(true);
+	}
+
+	Prefetcher.Tick();
+}
+
+void FGitSourceControlProvider::SaveSnapshot(bool bInAsync)
+{
+	LastSnapshotTime = FPlatformTime::Seconds();
+	bSnapshotDirty = false;
+
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	auto Save = [this, PathToGitBinary = GitSourceControl.AccessSettings().GetBinaryPath(), RepositoryRoot = PathToRepositoryRoot]()
+	{
+		FGitSnapshotKey Key;
+		return FGitSourceControlSnapshot::ReadKey(PathToGitBinary, RepositoryRoot, Key)
+			&& FGitSourceControlSnapshot::Save(FGitSourceControlSnapshot::GetDefaultFilename(), Key, StateCache);
+	};
+	if(bInAsync)
+	{
+		// Close() waits for it before emptying the cache
+		SnapshotSaveTask = Async(EAsyncExecution::ThreadPool, MoveTemp(Save));
+	}
+	else
+	{
+		Save();
+	}
 }
 
 TArray< TSharedRef<ISourceControlLabel> > FGitSourceControlProvider::GetLabels( const FString& InMatchingSpec ) const
@@ -478,21 +669,27 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 		FScopedSourceControlProgress Progress(Task);
 
 		// Issue the command asynchronously...
+		InCommand.CompletionEvent = FPlatformProcess::GetSynchEventFromPool(true);
 		IssueCommand( InCommand );
 
-		// ... then wait for its completion (thus making it synchronous)
-		while(!InCommand.bExecuteProcessed)
+		// ... then wait for its completion (thus making it synchronous), returning as soon as it is done
+		static const uint32 ProgressTickIntervalMs = 50;
+		while(!InCommand.CompletionEvent->Wait(ProgressTickIntervalMs))
 		{
 			// Tick the command queue and update progress.
 			Tick();
 
 			Progress.Tick();
-
-			// Sleep for a bit so we don't busy-wait so much.
-			FPlatformProcess::Sleep(0.01f);
 		}
+		FPlatformProcess::ReturnSynchEventToPool(InCommand.CompletionEvent);
+		InCommand.CompletionEvent = nullptr;
+
+		// apply the results of the command, as Tick() does for asynchronous commands
+		bStatesUpdatedPending |= InCommand.Worker->UpdateStates();
+		OutputCommandMessages(InCommand);
+		InCommand.ReturnResults();
 
-		// always do one more Tick() to make sure the command queue is cleaned up.
+		// always do one more Tick() to apply other completed commands, and to broadcast the state changes once for all
 		Tick();
 
 		if(InCommand.bCommandSuccessful)
@@ -503,12 +700,6 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 
 	// Delete the command now (asynchronous commands are deleted in the Tick() method)
 	check(!InCommand.bAutoDelete);
-
-	// ensure commands that are not auto deleted do not end up in the command queue
-	if ( CommandQueue.Contains( &InCommand ) )
-	{
-		CommandQueue.Remove( &InCommand );
-	}
 	delete &InCommand;
 
 	return Result;
@@ -519,8 +710,8 @@ ECommandResult::Type FGitSourceControlProvider::IssueCommand(FGitSourceControlCo
 	if(GThreadPool != nullptr)
 	{
 		// Queue this to our worker thread(s) for resolving
+		InCommand.CompletionQueue = &CompletedCommands;
 		GThreadPool->AddQueuedWork(&InCommand);
-		CommandQueue.Add(&InCommand);
 		return ECommandResult::Succeeded;
 	}
 	else
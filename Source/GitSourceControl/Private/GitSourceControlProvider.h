@@ -7,6 +7,18 @@
 #include "ISourceControlState.h"
 #include "ISourceControlProvider.h"
 #include "IGitSourceControlWorker.h"
+#include "GitSourceControlPrefetcher.h"
+#include "GitSourceControlClaimIndex.h"
+#include "GitSourceControlSpreadEngine.h"
+#include "GitSourceControlClaimJournal.h"
+#include "GitSourceControlClaimStore.h"
+#include "GitSourceControlClaimSubscription.h"
+#include "GitSourceControlGitalongConfig.h"
+#include "GitSourceControlPermissions.h"
+#include "GitSourceControlStateCache.h"
+#include "GitSourceControlSnapshot.h"
+#include "GitSourceControlCommitTable.h"
+#include "Async/Future.h"
 
 class FGitSourceControlState;
 
@@ -14,6 +26,9 @@ class FGitSourceControlCommand;
 
 DECLARE_DELEGATE_RetVal(FGitSourceControlWorkerRef, FGetGitSourceControlWorker)
 
+/** Delegate called with the files whose state changed, and which of their fields changed */
+DECLARE_MULTICAST_DELEGATE_OneParam(FGitSourceControlStateDeltaDelegate, const FGitSourceControlStateDelta& /*Delta*/)
+
 struct FGitVersion
 {
 	int Major;
@@ -144,17 +159,101 @@ public:
 		return RemoteUrl;
 	}
 
-	/** Helper function used to update state cache */
+	/** Name of the current branch */
+	inline const FString& GetBranchName() const
+	{
+		return BranchName;
+	}
+
+	/** Get the cached state of a file: an immutable snapshot, use GetStateCache().Update() to publish a new one */
 	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> GetStateInternal(const FString& Filename);
 
+	/** Find a state in the cache, without adding it when missing */
+	TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> FindStateInternal(const FString& Filename) const;
+
+	/** Get the cached states matching a predicate among the files of some indices only, instead of the whole cache */
+	TArray<FSourceControlStateRef> GetCachedStateByPredicate(EGitStateIndex InIndices, TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const;
+
 	/**
 	 * Register a worker with the provider.
 	 * This is used internally so the provider can maintain a map of all available operations.
 	 */
 	void RegisterWorker( const FName& InName, const FGetGitSourceControlWorker& InDelegate );
 
+	/**
+	 * Register to be told which files and which of their fields changed, so that listeners only refresh what changed.
+	 * Changes are accumulated and broadcast from Tick() at most every StateDeltaIntervalMs.
+	 */
+	FDelegateHandle RegisterStateDelta_Handle(const FGitSourceControlStateDeltaDelegate::FDelegate& InStateDelta);
+	void UnregisterStateDelta_Handle(FDelegateHandle Handle);
+
 	/** Remove a named file from the state cache */
 	bool RemoveFileFromCache(const FString& Filename);
+
+	/** Concurrent cache of file states, updated directly by worker threads */
+	inline FGitSourceControlStateCache& GetStateCache()
+	{
+		return StateCache;
+	}
+
+	/** Commits of the loaded histories, shared by the revisions of the files they touched */
+	inline FGitSourceControlCommitTable& GetCommitTable()
+	{
+		return CommitTable;
+	}
+
+	/** Team wide index of claimed files, to query claims by author, host, branch or spread */
+	inline FGitSourceControlClaimIndex& GetClaimIndex()
+	{
+		return ClaimIndex;
+	}
+
+	inline const FGitSourceControlClaimIndex& GetClaimIndex() const
+	{
+		return ClaimIndex;
+	}
+
+	/** Plugin side computation of local and remote spread bits */
+	inline FGitSourceControlSpreadEngine& GetSpreadEngine()
+	{
+		return SpreadEngine;
+	}
+
+	/** Local journal of Gitalong claims and updates, replayed in the background */
+	inline FGitSourceControlClaimJournal& GetClaimJournal()
+	{
+		return ClaimJournal;
+	}
+
+	/** In-plugin client of the Gitalong claim store */
+	inline FGitSourceControlClaimStore& GetClaimStore()
+	{
+		return ClaimStore;
+	}
+
+	/** In-memory copy of the Gitalong config of the repository */
+	inline const FGitSourceControlGitalongConfig& GetGitalongConfig() const
+	{
+		return GitalongConfig;
+	}
+
+	/** Read-only flag of files driven by their state */
+	inline FGitSourceControlPermissionManager& GetPermissionManager()
+	{
+		return PermissionManager;
+	}
+
+	/** Subscription to claim changes pushed by a relay of the claim store */
+	inline const FGitSourceControlClaimSubscription& GetClaimSubscription() const
+	{
+		return ClaimSubscription;
+	}
+
+	/** States of the last session, until validated by the "Connect" operation */
+	inline FGitSourceControlSnapshot& GetSnapshot()
+	{
+		return Snapshot;
+	}
 	
 private:
 
@@ -178,6 +277,9 @@ private:
 	/** Output any messages this command holds */
 	void OutputCommandMessages(const class FGitSourceControlCommand& InCommand) const;
 
+	/** (Re)configure the claim store client and its relay subscription from the current Gitalong config */
+	void ConfigureClaimStore();
+
 	/** Path to the root of the Git repository: can be the ProjectDir itself, or any parent directory (found by the "Connect" operation) */
 	FString PathToRepositoryRoot;
 
@@ -197,20 +299,75 @@ private:
 	FString RemoteUrl;
 
 	/** State cache */
-	TMap<FString, TSharedRef<class FGitSourceControlState, ESPMode::ThreadSafe> > StateCache;
+	FGitSourceControlStateCache StateCache;
 
 	/** The currently registered source control operations */
 	TMap<FName, FGetGitSourceControlWorker> WorkersMap;
 
-	/** Queue for commands given by the main thread */
-	TArray < FGitSourceControlCommand* > CommandQueue;
+	/** Commands executed by worker threads, waiting for their results to be applied by Tick() */
+	TQueue<FGitSourceControlCommand*, EQueueMode::Mpsc> CompletedCommands;
 
 	/** For notifying when the source control states in the cache have changed */
 	FSourceControlStateChanged OnSourceControlStateChanged;
 
+	/** States were updated by a synchronous command: broadcast by the next Tick() */
+	bool bStatesUpdatedPending = false;
+
+	/** For notifying which files changed, and which of their fields */
+	FGitSourceControlStateDeltaDelegate OnStateDelta;
+
+	/** Changes accumulated until the next state delta notification */
+	FGitSourceControlStateDelta PendingStateDelta;
+
+	/** When the last state delta notification was sent */
+	double LastStateDeltaTime = 0.0;
+
+	/** Write a snapshot of the state cache for the next session, on a pool thread or right away */
+	void SaveSnapshot(bool bInAsync);
+
+	/** States of the last session */
+	FGitSourceControlSnapshot Snapshot;
+
+	/** Periodic save of the snapshot in flight */
+	TFuture<bool> SnapshotSaveTask;
+
+	/** When the snapshot was last saved, and whether states changed since */
+	double LastSnapshotTime = 0.0;
+	bool bSnapshotDirty = false;
+
 	/** Git version for feature checking */
 	FGitVersion GitVersion;
 
 	/** Gitalong version for feature checking */
 	FGitVersion GitalongVersion;
+
+	/** In-memory copy of the Gitalong config of the repository */
+	FGitSourceControlGitalongConfig GitalongConfig;
+
+	/** Revision of the Gitalong config last applied to the claim store client */
+	int32 GitalongConfigRevision = 0;
+
+	/** Commits of the loaded histories */
+	FGitSourceControlCommitTable CommitTable;
+
+	/** Team wide index of claimed files */
+	FGitSourceControlClaimIndex ClaimIndex;
+
+	/** Plugin side computation of local and remote spread bits */
+	FGitSourceControlSpreadEngine SpreadEngine;
+
+	/** Local journal of Gitalong claims and updates */
+	FGitSourceControlClaimJournal ClaimJournal;
+
+	/** In-plugin client of the Gitalong claim store */
+	FGitSourceControlClaimStore ClaimStore;
+
+	/** Subscription to claim changes pushed by a relay of the claim store */
+	FGitSourceControlClaimSubscription ClaimSubscription;
+
+	/** Read-only flag of files driven by their state */
+	FGitSourceControlPermissionManager PermissionManager;
+
+	/** Refresh the status of assets being opened or selected ahead of time */
+	FGitSourceControlPrefetcher Prefetcher;
 };
@@ -28,12 +28,12 @@ bool FGitSourceControlRevision::Get(FString& InOutFilename, EConcurrency::Type I
 		// create the diff dir if we don't already have it (Git wont)
 		IFileManager::Get().MakeDirectory(*FPaths::DiffDir(), true);
 		// create a unique temp file name based on the unique commit Id
-		const FString TempFileName = FString::Printf(TEXT("%stemp-%s-%s"), *FPaths::DiffDir(), *CommitId, *FPaths::GetCleanFilename(Filename));
+		const FString TempFileName = FString::Printf(TEXT("%stemp-%s-%s"), *FPaths::DiffDir(), *Commit->CommitId, *FPaths::GetCleanFilename(Filename));
 		InOutFilename = FPaths::ConvertRelativePathToFull(TempFileName);
 	}
 
 	// Diff against the revision
-	const FString Parameter = FString::Printf(TEXT("%s:%s"), *CommitId, *Filename);
+	const FString Parameter = FString::Printf(TEXT("%s:%s"), *Commit->CommitId, *Filename);
 
 	bool bCommandSuccessful;
 	if(FPaths::FileExists(InOutFilename))
@@ -69,17 +69,17 @@ int32 FGitSourceControlRevision::GetRevisionNumber() const
 
 const FString& FGitSourceControlRevision::GetRevision() const
 {
-	return ShortCommitId;
+	return Commit->ShortCommitId;
 }
 
 const FString& FGitSourceControlRevision::GetDescription() const
 {
-	return Description;
+	return Commit->Description;
 }
 
 const FString& FGitSourceControlRevision::GetUserName() const
 {
-	return UserName;
+	return Commit->UserName;
 }
 
 const FString& FGitSourceControlRevision::GetClientSpec() const
@@ -101,12 +101,12 @@ TSharedPtr<class ISourceControlRevision, ESPMode::ThreadSafe> FGitSourceControlR
 
 const FDateTime& FGitSourceControlRevision::GetDate() const
 {
-	return Date;
+	return Commit->Date;
 }
 
 int32 FGitSourceControlRevision::GetCheckInIdentifier() const
 {
-	return CommitIdNumber;
+	return Commit->CommitIdNumber;
 }
 
 int32 FGitSourceControlRevision::GetFileSize() const
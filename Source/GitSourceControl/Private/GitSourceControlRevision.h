@@ -6,13 +6,16 @@
 #include "ISourceControlProvider.h"
 #include "ISourceControlRevision.h"
 #include "Misc/DateTime.h"
+#include "GitSourceControlCommitTable.h"
 
 /** Revision of a file, linked to a specific commit */
 class FGitSourceControlRevision : public ISourceControlRevision
 {
 public:
-	FGitSourceControlRevision()
-		: RevisionNumber(0)
+	explicit FGitSourceControlRevision(const FGitCommitRef& InCommit)
+		: Commit(InCommit)
+		, RevisionNumber(0)
+		, FileSize(0)
 	{
 	}
 
@@ -37,14 +40,8 @@ public:
 	/** The filename this revision refers to */
 	FString Filename;
 
-	/** The full hexadecimal SHA1 id of the commit this revision refers to */
-	FString CommitId;
-
-	/** The short hexadecimal SHA1 id (8 first hex char out of 40) of the commit: the string to display */
-	FString ShortCommitId;
-
-	/** The numeric value of the short SHA1 (8 first hex char out of 40) */
-	int32 CommitIdNumber;
+	/** The commit this revision refers to (id, description, author and date), shared with the revisions of the other files it touched */
+	FGitCommitRef Commit;
 
 	/** The index of the revision in the history (SBlueprintRevisionMenu assumes order for the "Depot" label) */
 	int32 RevisionNumber;
@@ -52,21 +49,12 @@ public:
 	/** The SHA1 identifier of the file at this revision */
 	FString FileHash;
 
-	/** The description of this revision */
-	FString Description;
-
-	/** The user that made the change */
-	FString UserName;
-
 	/** The action (add, edit, branch etc.) performed at this revision */
 	FString Action;
 
 	/** Source of move ("branch" in Perforce term) if any */
 	TSharedPtr<FGitSourceControlRevision, ESPMode::ThreadSafe> BranchSource;
 
-	/** The date this revision was made */
-	FDateTime Date;
-
 	/** The size of the file at this revision */
 	int32 FileSize;
 };
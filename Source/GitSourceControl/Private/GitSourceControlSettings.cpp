@@ -51,6 +51,72 @@ bool FGitSourceControlSettings::SetGitalongBinaryPath(const FString& InString)
 	return bChanged;
 }
 
+bool FGitSourceControlSettings::IsOptimisticCheckOutEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bOptimisticCheckOut;
+}
+
+bool FGitSourceControlSettings::IsStatusPrefetchEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bStatusPrefetch;
+}
+
+bool FGitSourceControlSettings::IsLocalSpreadEngineEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bLocalSpreadEngine;
+}
+
+bool FGitSourceControlSettings::IsAbortSyncOnConflictForecastEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bAbortSyncOnConflictForecast;
+}
+
+bool FGitSourceControlSettings::IsClaimJournalEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bClaimJournal;
+}
+
+bool FGitSourceControlSettings::IsClaimStoreClientEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bClaimStoreClient;
+}
+
+bool FGitSourceControlSettings::IsClaimSubscriptionEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bClaimSubscription;
+}
+
+float FGitSourceControlSettings::GetCommandTickBudgetMs() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return CommandTickBudgetMs;
+}
+
+float FGitSourceControlSettings::GetStateDeltaIntervalMs() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return StateDeltaIntervalMs;
+}
+
+bool FGitSourceControlSettings::IsStateSnapshotEnabled() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bStateSnapshot;
+}
+
+int32 FGitSourceControlSettings::GetHistoryBudgetMB() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return HistoryBudgetMB;
+}
+
 // This is called at startup nearly before anything else in our module: BinaryPath will then be used by the provider
 void FGitSourceControlSettings::LoadSettings()
 {
@@ -58,6 +124,17 @@ void FGitSourceControlSettings::LoadSettings()
 	const FString& IniFile = SourceControlHelpers::GetSettingsIni();
 	GConfig->GetString(*GitSettingsConstants::SettingsSection, TEXT("BinaryPath"), BinaryPath, IniFile);
 	GConfig->GetString(*GitSettingsConstants::SettingsSection, TEXT("GitalongBinaryPath"), GitalongBinaryPath, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("OptimisticCheckOut"), bOptimisticCheckOut, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("StatusPrefetch"), bStatusPrefetch, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("LocalSpreadEngine"), bLocalSpreadEngine, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("AbortSyncOnConflictForecast"), bAbortSyncOnConflictForecast, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("ClaimJournal"), bClaimJournal, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("ClaimStoreClient"), bClaimStoreClient, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("ClaimSubscription"), bClaimSubscription, IniFile);
+	GConfig->GetFloat(*GitSettingsConstants::SettingsSection, TEXT("CommandTickBudgetMs"), CommandTickBudgetMs, IniFile);
+	GConfig->GetFloat(*GitSettingsConstants::SettingsSection, TEXT("StateDeltaIntervalMs"), StateDeltaIntervalMs, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("StateSnapshot"), bStateSnapshot, IniFile);
+	GConfig->GetInt(*GitSettingsConstants::SettingsSection, TEXT("HistoryBudgetMB"), HistoryBudgetMB, IniFile);
 }
 
 void FGitSourceControlSettings::SaveSettings() const
@@ -66,4 +143,15 @@ void FGitSourceControlSettings::SaveSettings() const
 	const FString& IniFile = SourceControlHelpers::GetSettingsIni();
 	GConfig->SetString(*GitSettingsConstants::SettingsSection, TEXT("BinaryPath"), *BinaryPath, IniFile);
 	GConfig->SetString(*GitSettingsConstants::SettingsSection, TEXT("GitalongBinaryPath"), *GitalongBinaryPath, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("OptimisticCheckOut"), bOptimisticCheckOut, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("StatusPrefetch"), bStatusPrefetch, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("LocalSpreadEngine"), bLocalSpreadEngine, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("AbortSyncOnConflictForecast"), bAbortSyncOnConflictForecast, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("ClaimJournal"), bClaimJournal, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("ClaimStoreClient"), bClaimStoreClient, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("ClaimSubscription"), bClaimSubscription, IniFile);
+	GConfig->SetFloat(*GitSettingsConstants::SettingsSection, TEXT("CommandTickBudgetMs"), CommandTickBudgetMs, IniFile);
+	GConfig->SetFloat(*GitSettingsConstants::SettingsSection, TEXT("StateDeltaIntervalMs"), StateDeltaIntervalMs, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("StateSnapshot"), bStateSnapshot, IniFile);
+	GConfig->SetInt(*GitSettingsConstants::SettingsSection, TEXT("HistoryBudgetMB"), HistoryBudgetMB, IniFile);
 }
@@ -22,6 +22,39 @@ public:
 
 	/** Set the Gitalong Binary Path */
 	bool SetGitalongBinaryPath(const FString& InString);
+
+	/** Whether CheckOut marks files as claimed right away and confirms the claim in the background */
+	bool IsOptimisticCheckOutEnabled() const;
+
+	/** Whether the status of assets being opened or selected is refreshed ahead of time */
+	bool IsStatusPrefetchEnabled() const;
+
+	/** Whether local and remote spread bits are computed by the plugin from refs instead of asking Gitalong for each file */
+	bool IsLocalSpreadEngineEnabled() const;
+
+	/** Whether Sync is aborted (instead of only reported) when incoming commits change locally modified or claimed files */
+	bool IsAbortSyncOnConflictForecastEnabled() const;
+
+	/** Whether Gitalong claims and updates are committed to a local journal and replayed in the background */
+	bool IsClaimJournalEnabled() const;
+
+	/** Whether team claims are fetched by the plugin from the Gitalong claim store instead of the Gitalong command line */
+	bool IsClaimStoreClientEnabled() const;
+
+	/** Whether claim changes are pushed by the relay of the claim store instead of polled */
+	bool IsClaimSubscriptionEnabled() const;
+
+	/** Milliseconds per frame spent applying the results of completed commands */
+	float GetCommandTickBudgetMs() const;
+
+	/** Minimum milliseconds between two state delta notifications */
+	float GetStateDeltaIntervalMs() const;
+
+	/** Persist the state cache to show states as soon as the Editor starts */
+	bool IsStateSnapshotEnabled() const;
+
+	/** Megabytes of file histories kept in the state cache before the least recently used ones are evicted */
+	int32 GetHistoryBudgetMB() const;
 	
 	/** Load settings from ini file */
 	void LoadSettings();
@@ -38,4 +71,37 @@ private:
 
 	/** Git Gitalong binary path */
 	FString GitalongBinaryPath;
+
+	/** Optimistic CheckOut mode */
+	bool bOptimisticCheckOut = false;
+
+	/** Speculative status prefetch */
+	bool bStatusPrefetch = true;
+
+	/** Plugin side spread computation */
+	bool bLocalSpreadEngine = false;
+
+	/** Abort Sync on forecast conflicts */
+	bool bAbortSyncOnConflictForecast = true;
+
+	/** Journal Gitalong claims and updates */
+	bool bClaimJournal = false;
+
+	/** Fetch team claims from the claim store */
+	bool bClaimStoreClient = false;
+
+	/** Subscribe to claim changes pushed by a relay */
+	bool bClaimSubscription = false;
+
+	/** Time budget per frame for completed commands */
+	float CommandTickBudgetMs = 5.0f;
+
+	/** Throttling of state delta notifications */
+	float StateDeltaIntervalMs = 100.0f;
+
+	/** Save and load a snapshot of the state cache */
+	bool bStateSnapshot = false;
+
+	/** Memory budget of cached histories */
+	int32 HistoryBudgetMB = 64;
 };
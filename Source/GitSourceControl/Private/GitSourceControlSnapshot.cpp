@@ -0,0 +1,408 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlSnapshot.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "ISourceControlModule.h"
+#include "GitSourceControlStateCache.h"
+#include "GitSourceControlUtils.h"
+
+/** "GSCS" */
+static constexpr uint32 SnapshotMagic = 0x53435347;
+
+/** Size of the SHA-1 checksum ending the Git index */
+static constexpr int64 IndexChecksumSize = 20;
+
+FString FGitSourceControlSnapshot::GetDefaultFilename()
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Gitalong") / TEXT("StateCache.bin"));
+}
+
+bool FGitSourceControlSnapshot::ReadKey(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FGitSnapshotKey& OutKey)
+{
+	OutKey.RepositoryRoot = InRepositoryRoot;
+
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("HEAD"));
+	if(!GitSourceControlUtils::RunCommand(TEXT("rev-parse"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), Results, ErrorMessages) || Results.Num() == 0)
+	{
+		return false;
+	}
+	OutKey.Head = Results[0];
+
+	// Git ends its index with the checksum of its content: read it instead of hashing the whole file
+	OutKey.IndexChecksum.Empty();
+	const FString IndexFilename = FPaths::Combine(InRepositoryRoot, TEXT(".git"), TEXT("index"));
+	TUniquePtr<IFileHandle> IndexFile(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*IndexFilename));
+	if(IndexFile.IsValid() && IndexFile->Size() > IndexChecksumSize && IndexFile->Seek(IndexFile->Size() - IndexChecksumSize))
+	{
+		uint8 Checksum[IndexChecksumSize];
+		if(IndexFile->Read(Checksum, IndexChecksumSize))
+		{
+			OutKey.IndexChecksum = BytesToHex(Checksum, IndexChecksumSize);
+		}
+	}
+
+	// Branches, as for the refresh of the spread engine: without them, the files are all queried again
+	OutKey.Refs.Reset();
+	Results.Reset();
+	Parameters.Reset();
+	Parameters.Add(TEXT("--format=\"%(objectname) %(refname)\""));
+	Parameters.Add(TEXT("refs/heads"));
+	Parameters.Add(TEXT("refs/remotes"));
+	if(GitSourceControlUtils::RunCommand(TEXT("for-each-ref"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), Results, ErrorMessages))
+	{
+		for(const FString& Result : Results)
+		{
+			FString Sha;
+			FString RefName;
+			if(Result.Split(TEXT(" "), &Sha, &RefName))
+			{
+				OutKey.Refs.Add(RefName, Sha);
+			}
+		}
+	}
+	return true;
+}
+
+bool FGitSourceControlSnapshot::Save(const FString& InFilename, const FGitSnapshotKey& InKey, const FGitSourceControlStateCache& InStateCache)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	FDateTime SnapshotTimeStamp = FDateTime::UtcNow();
+
+	// Strings shared by many files are written once, and referenced by index
+	TArray<FString> Strings;
+	TMap<uint32, int32> StringIndices;
+	auto GetStringIndex = [&Strings, &StringIndices](const FGitInternedString& InString)
+	{
+		int32& Index = StringIndices.FindOrAdd(InString.GetId(), INDEX_NONE);
+		if(Index == INDEX_NONE)
+		{
+			Index = Strings.Add(InString.ToString());
+		}
+		return Index;
+	};
+	auto WriteBranches = [&GetStringIndex](FArchive& Ar, const TArray<FGitInternedString>& InBranches)
+	{
+		int32 NumBranches = InBranches.Num();
+		Ar << NumBranches;
+		for(const FGitInternedString& Branch : InBranches)
+		{
+			int32 Index = GetStringIndex(Branch);
+			Ar << Index;
+		}
+	};
+
+	TArray<uint8> Records;
+	FMemoryWriter RecordsWriter(Records);
+	int32 NumStates = 0;
+	InStateCache.ForEach([&](const FGitSourceControlStateCache::FStateRef& InState)
+	{
+		const FGitSourceControlState& State = *InState;
+		if(State.WorkingCopyState == EWorkingCopyState::Unknown && State.LastCommitSpread == ECommitSpread::Unknown)
+		{
+			// nothing worth showing before the first status
+			return;
+		}
+		FString RelativeFilename = State.LocalFilename;
+		if(!FPaths::MakePathRelativeTo(RelativeFilename, *(InKey.RepositoryRoot / TEXT(""))) || RelativeFilename.StartsWith(TEXT("..")))
+		{
+			// outside of the repository
+			return;
+		}
+		uint8 WorkingCopyState = (uint8)State.WorkingCopyState;
+		uint8 Spread = (uint8)State.LastCommitSpread;
+		// shas are all different: written as 20 bytes rather than shared strings, followed by the value itself when it is not a SHA-1
+		FSHAHash Sha = FGitSourceControlStateCache::ToShaHash(State.LastCommitSha);
+		FString OtherSha = (Sha == FSHAHash()) ? State.LastCommitSha : FString();
+		int32 Author = GetStringIndex(State.LastCommitAuthor);
+		int32 Host = GetStringIndex(State.LastCommitHost);
+		int64 SpreadTimeStamp = State.SpreadTimeStamp.GetTicks();
+		RecordsWriter << RelativeFilename << WorkingCopyState << Spread << Sha;
+		if(Sha == FSHAHash())
+		{
+			RecordsWriter << OtherSha;
+		}
+		RecordsWriter << Author << Host;
+		WriteBranches(RecordsWriter, State.LastCommitLocalBranches);
+		WriteBranches(RecordsWriter, State.LastCommitRemoteBranches);
+		RecordsWriter << SpreadTimeStamp;
+		NumStates++;
+	});
+
+	TArray<uint8> Content;
+	FMemoryWriter Writer(Content);
+	uint32 Magic = SnapshotMagic;
+	int32 FileVersion = Version;
+	FString RepositoryRoot = InKey.RepositoryRoot;
+	FString Head = InKey.Head;
+	FString IndexChecksum = InKey.IndexChecksum;
+	TMap<FString, FString> Refs = InKey.Refs;
+	int64 TimeStampTicks = SnapshotTimeStamp.GetTicks();
+	Writer << Magic << FileVersion << RepositoryRoot << Head << IndexChecksum << Refs << TimeStampTicks;
+	Writer << Strings;
+	Writer << NumStates;
+	Writer.Serialize(Records.GetData(), Records.Num());
+
+	// Write next to the previous snapshot then replace it, so that a crash never leaves a truncated snapshot
+	const FString TempFilename = InFilename + TEXT(".tmp");
+	if(!FFileHelper::SaveArrayToFile(Content, *TempFilename) || !IFileManager::Get().Move(*InFilename, *TempFilename, true, true))
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Snapshot: failed to write '%s'"), *InFilename);
+		return false;
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("Snapshot: %d state(s) saved in %.3lfs (%d KiB)"), NumStates, FPlatformTime::Seconds() - StartTime, Content.Num() / 1024);
+	return true;
+}
+
+bool FGitSourceControlSnapshot::Load(const FString& InFilename, const FString& InRepositoryRoot)
+{
+	Reset();
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Map the file instead of reading it when the platform supports it (the region is released before the file)
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*InFilename));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion(0, MappedFile->GetFileSize()) : nullptr);
+	TArray<uint8> Content;
+	TArrayView<const uint8> View;
+	if(MappedRegion.IsValid())
+	{
+		View = MakeArrayView(MappedRegion->GetMappedPtr(), (int32)MappedRegion->GetMappedSize());
+	}
+	else if(FFileHelper::LoadFileToArray(Content, *InFilename, FILEREAD_Silent))
+	{
+		View = Content;
+	}
+	else
+	{
+		return false;
+	}
+
+	FMemoryReaderView Reader(View);
+	uint32 Magic = 0;
+	int32 FileVersion = 0;
+	Reader << Magic << FileVersion;
+	if(Reader.IsError() || Magic != SnapshotMagic || FileVersion != Version)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Snapshot: ignoring '%s' (version %d)"), *InFilename, FileVersion);
+		return false;
+	}
+	int64 TimeStampTicks = 0;
+	Reader << Key.RepositoryRoot << Key.Head << Key.IndexChecksum << Key.Refs << TimeStampTicks;
+	if(Reader.IsError() || Key.RepositoryRoot != InRepositoryRoot)
+	{
+		Reset();
+		return false;
+	}
+	TimeStamp = FDateTime(TimeStampTicks);
+
+	TArray<FString> Strings;
+	Reader << Strings;
+	TArray<FGitInternedString> InternedStrings;
+	InternedStrings.Reserve(Strings.Num());
+	for(const FString& String : Strings)
+	{
+		InternedStrings.Emplace(String);
+	}
+	auto ReadString = [&Reader, &InternedStrings]()
+	{
+		int32 Index = 0;
+		Reader << Index;
+		if(!InternedStrings.IsValidIndex(Index))
+		{
+			Reader.SetError();
+			return FGitInternedString();
+		}
+		return InternedStrings[Index];
+	};
+	auto ReadBranches = [&Reader, &ReadString](TArray<FGitInternedString>& OutBranches)
+	{
+		int32 NumBranches = 0;
+		Reader << NumBranches;
+		if(NumBranches < 0 || NumBranches > Reader.TotalSize() - Reader.Tell())
+		{
+			Reader.SetError();
+			return;
+		}
+		OutBranches.Reserve(NumBranches);
+		for(int32 Index = 0; Index < NumBranches && !Reader.IsError(); Index++)
+		{
+			OutBranches.Add(ReadString());
+		}
+	};
+
+	int32 NumStates = 0;
+	Reader << NumStates;
+	if(NumStates < 0 || NumStates > Reader.TotalSize() - Reader.Tell())
+	{
+		Reset();
+		return false;
+	}
+	States.Reserve(NumStates);
+	FString RelativeFilename;
+	for(int32 Index = 0; Index < NumStates && !Reader.IsError(); Index++)
+	{
+		Reader << RelativeFilename;
+		FGitSourceControlState& State = States.Emplace_GetRef(FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename));
+		uint8 WorkingCopyState = 0;
+		uint8 Spread = 0;
+		Reader << WorkingCopyState << Spread;
+		State.WorkingCopyState = (EWorkingCopyState::Type)WorkingCopyState;
+		State.LastCommitSpread = (ECommitSpread)Spread;
+		FSHAHash Sha;
+		Reader << Sha;
+		if(Sha == FSHAHash())
+		{
+			Reader << State.LastCommitSha;
+		}
+		else
+		{
+			State.LastCommitSha = FGitSourceControlStateCache::FromShaHash(Sha);
+		}
+		State.LastCommitAuthor = ReadString();
+		State.LastCommitHost = ReadString();
+		ReadBranches(State.LastCommitLocalBranches);
+		ReadBranches(State.LastCommitRemoteBranches);
+		int64 SpreadTimeStamp = 0;
+		Reader << SpreadTimeStamp;
+		State.SpreadTimeStamp = FDateTime(SpreadTimeStamp);
+	}
+	if(Reader.IsError())
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Snapshot: '%s' is corrupted"), *InFilename);
+		Reset();
+		return false;
+	}
+
+	bLoaded = true;
+	UE_LOG(LogSourceControl, Log, TEXT("Snapshot: %d state(s) loaded in %.3lfs"), States.Num(), FPlatformTime::Seconds() - StartTime);
+	return true;
+}
+
+void FGitSourceControlSnapshot::Reset()
+{
+	bLoaded = false;
+	Key = FGitSnapshotKey();
+	TimeStamp = FDateTime(0);
+	States.Empty();
+}
+
+bool FGitSourceControlSnapshot::GetInvalidatedFiles(const FString& InPathToGitBinary, const FGitSnapshotKey& InCurrentKey, const TArray<FString>& InDirectories, TArray<FString>& OutFiles) const
+{
+	if(!bLoaded || InCurrentKey.RepositoryRoot != Key.RepositoryRoot)
+	{
+		return false;
+	}
+
+	TSet<FString> Files;
+
+	// Files modified on disk after the snapshot, and files that disappeared since
+	TSet<FString> MissingFiles;
+	MissingFiles.Reserve(States.Num());
+	for(const FGitSourceControlState& State : States)
+	{
+		MissingFiles.Add(State.LocalFilename);
+	}
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for(const FString& Directory : InDirectories)
+	{
+		PlatformFile.IterateDirectoryStatRecursively(*Directory, [this, &Files, &MissingFiles](const TCHAR* InFilename, const FFileStatData& InStatData)
+		{
+			if(!InStatData.bIsDirectory)
+			{
+				MissingFiles.Remove(InFilename);
+				if(InStatData.ModificationTime > TimeStamp)
+				{
+					Files.Add(InFilename);
+				}
+			}
+			return true;
+		});
+	}
+	Files.Append(MissingFiles);
+
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	if(InCurrentKey.Head != Key.Head)
+	{
+		// Files changed by the move of HEAD (commit, checkout, pull...) while the Editor was closed
+		TArray<FString> Parameters;
+		Parameters.Add(TEXT("--name-only"));
+		Parameters.Add(Key.Head);
+		Parameters.Add(InCurrentKey.Head);
+		if(!GitSourceControlUtils::RunCommand(TEXT("diff"), InPathToGitBinary, Key.RepositoryRoot, Parameters, TArray<FString>(), Results, ErrorMessages))
+		{
+			// the previous HEAD is not reachable anymore
+			return false;
+		}
+	}
+	if(InCurrentKey.Refs.Num() == 0 && Key.Refs.Num() > 0)
+	{
+		// the branches could not be read
+		return false;
+	}
+	TSet<FString> RefNames;
+	InCurrentKey.Refs.GetKeys(RefNames);
+	for(const auto& Ref : Key.Refs)
+	{
+		RefNames.Add(Ref.Key);
+	}
+	for(const FString& RefName : RefNames)
+	{
+		const FString* OldSha = Key.Refs.Find(RefName);
+		const FString* NewSha = InCurrentKey.Refs.Find(RefName);
+		if(OldSha != nullptr && NewSha != nullptr && *OldSha == *NewSha)
+		{
+			continue;
+		}
+		// Files changed by the move of a branch, or in a branch created or deleted since it forked from HEAD: their spread changed
+		TArray<FString> Parameters;
+		Parameters.Add(TEXT("--name-only"));
+		if(OldSha != nullptr && NewSha != nullptr)
+		{
+			Parameters.Add(*OldSha);
+			Parameters.Add(*NewSha);
+		}
+		else
+		{
+			Parameters.Add(InCurrentKey.Head + TEXT("...") + (NewSha != nullptr ? *NewSha : *OldSha));
+		}
+		if(!GitSourceControlUtils::RunCommand(TEXT("diff"), InPathToGitBinary, Key.RepositoryRoot, Parameters, TArray<FString>(), Results, ErrorMessages))
+		{
+			// the previous tip of the branch is not reachable anymore
+			return false;
+		}
+	}
+	if(InCurrentKey.IndexChecksum.IsEmpty() || InCurrentKey.IndexChecksum != Key.IndexChecksum)
+	{
+		// Files staged while the Editor was closed, and files whose staged changes may have been committed or reset
+		TArray<FString> Parameters;
+		Parameters.Add(TEXT("--cached"));
+		Parameters.Add(TEXT("--name-only"));
+		if(!GitSourceControlUtils::RunCommand(TEXT("diff"), InPathToGitBinary, Key.RepositoryRoot, Parameters, TArray<FString>(), Results, ErrorMessages))
+		{
+			return false;
+		}
+		for(const FGitSourceControlState& State : States)
+		{
+			if(State.IsModified() || State.IsAdded() || State.IsDeleted() || State.IsConflicted())
+			{
+				Files.Add(State.LocalFilename);
+			}
+		}
+	}
+	for(const FString& Result : Results)
+	{
+		Files.Add(FPaths::ConvertRelativePathToFull(Key.RepositoryRoot, Result));
+	}
+
+	OutFiles = Files.Array();
+	return true;
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GitSourceControlState.h"
+
+class FGitSourceControlStateCache;
+
+/** Identity of the content of a repository when a snapshot was taken */
+struct FGitSnapshotKey
+{
+	/** Root of the repository */
+	FString RepositoryRoot;
+
+	/** Sha of HEAD */
+	FString Head;
+
+	/** Trailing checksum of the Git index, empty if unknown */
+	FString IndexChecksum;
+
+	/** Sha of each local and remote branch, by ref name: the spread of files depends on them too */
+	TMap<FString, FString> Refs;
+};
+
+/**
+ * Versioned binary snapshot of the state cache, to show correct states as soon as the Editor starts.
+ *
+ * Written on shutdown and periodically, read at startup through a memory mapped file.
+ * The claim index needs no data of its own: it is rebuilt from the spread of the loaded states.
+ * Loaded states are then validated incrementally so that only files changed while the Editor was closed are queried again.
+ */
+class FGitSourceControlSnapshot
+{
+public:
+	/** Default location of the snapshot of the project */
+	static FString GetDefaultFilename();
+
+	/** Read the key of the current content of a repository: HEAD, the checksum of the index and the branches */
+	static bool ReadKey(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FGitSnapshotKey& OutKey);
+
+	/** Write the cached states of a repository with their key */
+	static bool Save(const FString& InFilename, const FGitSnapshotKey& InKey, const FGitSourceControlStateCache& InStateCache);
+
+	/** Load a snapshot if it was taken from the provided repository with the current version of the format */
+	bool Load(const FString& InFilename, const FString& InRepositoryRoot);
+
+	/** Forget the loaded states */
+	void Reset();
+
+	bool IsLoaded() const
+	{
+		return bLoaded;
+	}
+
+	const FGitSnapshotKey& GetKey() const
+	{
+		return Key;
+	}
+
+	const TArray<FGitSourceControlState>& GetStates() const
+	{
+		return States;
+	}
+
+	/**
+	 * Files that changed since the snapshot was taken, to query again: modified on disk after it, or touched by a move of HEAD, changes to the index,
+	 * or a branch created, moved or deleted (fetch, push of a teammate...) which changes their spread.
+	 * @returns false if the snapshot cannot be validated (HEAD history rewritten...) and everything must be queried again
+	 */
+	bool GetInvalidatedFiles(const FString& InPathToGitBinary, const FGitSnapshotKey& InCurrentKey, const TArray<FString>& InDirectories, TArray<FString>& OutFiles) const;
+
+private:
+	/** Bumped whenever the layout of the file changes: older snapshots are then ignored */
+	static constexpr int32 Version = 4;
+
+	bool bLoaded = false;
+	FGitSnapshotKey Key;
+
+	/** When the snapshot was taken (UTC, like file modification times) */
+	FDateTime TimeStamp;
+
+	TArray<FGitSourceControlState> States;
+};
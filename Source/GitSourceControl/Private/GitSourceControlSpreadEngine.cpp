@@ -0,0 +1,269 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlSpreadEngine.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "ISourceControlModule.h"
+#include "GitSourceControlClaimIndex.h"
+#include "GitSourceControlUtils.h"
+
+/**
+ * Categorize the refs listed by a "for-each-ref" command into spread bits.
+ *
+ * Example output of git for-each-ref --format="%(objectname) %(HEAD) %(refname) %(upstream)" refs/heads refs/remotes
+0e3948fc383db8a0eb7081068d69f4f20a348a93 * refs/heads/feature-a refs/remotes/origin/feature-a
+3b18e512dba79e4c8300dd08aeb37f8e728b8dad   refs/heads/main refs/remotes/origin/main
+0e3948fc383db8a0eb7081068d69f4f20a348a93   refs/remotes/origin/feature-a
+3b18e512dba79e4c8300dd08aeb37f8e728b8dad   refs/remotes/origin/main
+ */
+static void ParseRefs(const TArray<FString>& InResults, TMap<FString, ECommitSpread>& OutTips)
+{
+	// First pass: find the active branch and its upstream
+	FString ActiveBranch;
+	FString ActiveUpstream;
+	for(const FString& Result : InResults)
+	{
+		TArray<FString> Splits;
+		Result.ParseIntoArrayWS(Splits);
+		if(Splits.Num() >= 3 && Splits[1] == TEXT("*"))
+		{
+			ActiveBranch = Splits[2].RightChop(11); // "refs/heads/"
+			ActiveUpstream = (Splits.Num() >= 4) ? Splits[3] : FString();
+		}
+	}
+
+	// Second pass: categorize each ref tip
+	for(const FString& Result : InResults)
+	{
+		TArray<FString> Splits;
+		Result.ParseIntoArrayWS(Splits);
+		if(Splits.Num() < 2)
+		{
+			continue;
+		}
+		const bool bIsHead = (Splits[1] == TEXT("*"));
+		const FString& Sha = Splits[0];
+		const FString& RefName = bIsHead ? Splits[2] : Splits[1];
+
+		ECommitSpread Spread = ECommitSpread::Unknown;
+		if(RefName.StartsWith(TEXT("refs/heads/")))
+		{
+			Spread = bIsHead ? ECommitSpread::LocalActiveBranch : ECommitSpread::LocalOtherBranch;
+		}
+		else if(RefName.StartsWith(TEXT("refs/remotes/")))
+		{
+			if(RefName.EndsWith(TEXT("/HEAD")))
+			{
+				continue; // symbolic ref to the default branch of the remote
+			}
+			const bool bMatching = ActiveUpstream.IsEmpty() ? (!ActiveBranch.IsEmpty() && RefName.EndsWith(TEXT("/") + ActiveBranch)) : (RefName == ActiveUpstream);
+			Spread = bMatching ? ECommitSpread::RemoteMatchingBranch : ECommitSpread::RemoteOtherBranch;
+		}
+		if(Spread != ECommitSpread::Unknown)
+		{
+			OutTips.FindOrAdd(Sha) |= Spread;
+		}
+	}
+}
+
+/**
+ * Walk the output of a "log --name-only" command (children always listed before their parents)
+ * to propagate spread bits from ref tips down to commits, and assign to each file the spread of its newest commit.
+ *
+ * Example output of git log --name-only --date-order --format="@%H %an%x09%P" <tips> --not <merge-base>
+@0e3948fc383db8a0eb7081068d69f4f20a348a93 Tim Sweeney	355f0df26ebd3888adbb558fd42bb8bd3e565000
+Content/Textures/T_Perlin_Noise_M.uasset
+@355f0df26ebd3888adbb558fd42bb8bd3e565000 Tim Sweeney	97a4e7626681895e073aaefd68b8ac087db81b0b
+Content/Materials/M_Basic_Wall.uasset
+ */
+static void ParseLogWalk(const FString& InRepositoryRoot, const TArray<FString>& InResults, TMap<FString, ECommitSpread>& InOutCommitSpreads, TMap<FString, FGitLocalSpread>& OutSpreads)
+{
+	ECommitSpread CommitSpread = ECommitSpread::Unknown;
+	FString CommitSha;
+	FGitInternedString CommitAuthor;
+	for(const FString& Result : InResults)
+	{
+		if(Result.StartsWith(TEXT("@")))
+		{
+			// Start of a new commit: its spread is final since all its children have already been walked
+			int32 TabIndex = INDEX_NONE;
+			Result.FindChar(TEXT('\t'), TabIndex);
+			const FString Header = (TabIndex != INDEX_NONE) ? Result.Mid(1, TabIndex - 1) : Result.RightChop(1);
+			CommitSha = Header.Left(40);
+			CommitAuthor = FGitInternedString(FStringView(Header).RightChop(41));
+			CommitSpread = InOutCommitSpreads.FindRef(CommitSha);
+
+			// Propagate to parents
+			if(TabIndex != INDEX_NONE)
+			{
+				TArray<FString> Parents;
+				Result.RightChop(TabIndex + 1).ParseIntoArrayWS(Parents);
+				for(const FString& Parent : Parents)
+				{
+					InOutCommitSpreads.FindOrAdd(Parent) |= CommitSpread;
+				}
+			}
+		}
+		else if(!CommitSha.IsEmpty())
+		{
+			const FString File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, Result);
+			if(!OutSpreads.Contains(File))
+			{
+				FGitLocalSpread& Spread = OutSpreads.Add(File);
+				Spread.Spread = CommitSpread;
+				Spread.CommitSha = CommitSha;
+				Spread.Author = CommitAuthor;
+			}
+		}
+	}
+}
+
+bool FGitSourceControlSpreadEngine::Refresh(const FString& InPathToGitBinary, const FString& InRepositoryRoot, TArray<FString>& OutErrorMessages)
+{
+	FScopeLock ScopeLock(&RefreshCriticalSection);
+
+	TArray<FString> RefResults;
+	{
+		TArray<FString> Parameters;
+		Parameters.Add(TEXT("--format=\"%(objectname) %(HEAD) %(refname) %(upstream)\""));
+		Parameters.Add(TEXT("refs/heads"));
+		Parameters.Add(TEXT("refs/remotes"));
+		if(!GitSourceControlUtils::RunCommand(TEXT("for-each-ref"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), RefResults, OutErrorMessages))
+		{
+			return false;
+		}
+	}
+
+	const FString Signature = FString::Join(RefResults, TEXT("\n"));
+	{
+		FReadScopeLock ReadLock(Lock);
+		if(bValid && Signature == RefsSignature)
+		{
+			// Refs did not move: nothing changed in the history
+			return true;
+		}
+	}
+
+	TMap<FString, ECommitSpread> CommitSpreads;
+	ParseRefs(RefResults, CommitSpreads);
+
+	// Merge base of each ref with HEAD, so that a single stale branch does not extend the walk to the whole history:
+	// files not changed since then in any ref get the spread of all refs
+	TArray<FString> MergeBases;
+	if(CommitSpreads.Num() > 1)
+	{
+		for(auto It = CommitSpreads.CreateIterator(); It; ++It)
+		{
+			TArray<FString> Parameters;
+			Parameters.Add(TEXT("HEAD"));
+			Parameters.Add(It.Key());
+			TArray<FString> MergeBaseResults;
+			TArray<FString> MergeBaseErrors;
+			if(GitSourceControlUtils::RunCommand(TEXT("merge-base"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), MergeBaseResults, MergeBaseErrors) && MergeBaseResults.Num() > 0)
+			{
+				MergeBases.AddUnique(MergeBaseResults[0]);
+			}
+			else
+			{
+				// Unrelated history: ignored rather than walked entirely
+				It.RemoveCurrent();
+			}
+		}
+	}
+	TArray<FString> Tips;
+	CommitSpreads.GetKeys(Tips);
+	ECommitSpread NewBaseSpread = ECommitSpread::Unknown;
+	for(const auto& Tip : CommitSpreads)
+	{
+		NewBaseSpread |= Tip.Value;
+	}
+
+	TMap<FString, FGitLocalSpread> NewSpreads;
+	if(Tips.Num() > 0)
+	{
+		if(Tips.Num() == 1)
+		{
+			MergeBases.Add(Tips[0]);
+		}
+
+		// Single walk of the history of each ref since its merge base with HEAD
+		TArray<FString> Parameters;
+		Parameters.Add(TEXT("--name-only"));
+		Parameters.Add(TEXT("--date-order"));
+		Parameters.Add(TEXT("--format=\"@%H %an%x09%P\""));
+		Parameters.Append(Tips);
+		if(MergeBases.Num() > 0)
+		{
+			Parameters.Add(TEXT("--not"));
+			Parameters.Append(MergeBases);
+		}
+		TArray<FString> LogResults;
+		if(!GitSourceControlUtils::RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), LogResults, OutErrorMessages))
+		{
+			return false;
+		}
+		ParseLogWalk(InRepositoryRoot, LogResults, CommitSpreads, NewSpreads);
+	}
+
+	UE_LOG(LogSourceControl, Log, TEXT("SpreadEngine: %d refs, %d files changed since their merge bases with HEAD"), Tips.Num(), NewSpreads.Num());
+
+	FWriteScopeLock WriteLock(Lock);
+	RefsSignature = Signature;
+	Spreads = MoveTemp(NewSpreads);
+	BaseSpread = NewBaseSpread;
+	bValid = true;
+	return true;
+}
+
+void FGitSourceControlSpreadEngine::Apply(const FGitSourceControlClaimIndex& InClaimIndex, FGitSourceControlState& InOutState) const
+{
+	FGitClaim Claim;
+	const bool bClaimed = InClaimIndex.Find(InOutState.LocalFilename, Claim);
+
+	// Local changes, or our own claim of a file not saved yet: exactly LocalUncommitted, as Gitalong reports them (see IsTruelyCheckedOut)
+	if(InOutState.IsModified() || (bClaimed && EnumHasAnyFlags(Claim.Spread, ECommitSpread::LocalUncommitted)))
+	{
+		InOutState.LastCommitSpread = ECommitSpread::LocalUncommitted;
+		return;
+	}
+
+	// Start from what Gitalong told us about other workstations
+	ECommitSpread Spread = bClaimed ? (Claim.Spread & CloneSpreadMask) : ECommitSpread::Unknown;
+	if(bClaimed && Spread != ECommitSpread::Unknown)
+	{
+		InOutState.LastCommitSha = Claim.CommitSha;
+		InOutState.LastCommitHost = Claim.Host;
+		InOutState.LastCommitAuthor = Claim.Author;
+		InOutState.LastCommitRemoteBranches = Claim.Branches;
+	}
+
+	// Then add what local refs tell us
+	{
+		FReadScopeLock ReadLock(Lock);
+		if(const FGitLocalSpread* LocalSpread = Spreads.Find(InOutState.LocalFilename))
+		{
+			Spread |= LocalSpread->Spread;
+			if(InOutState.LastCommitSha.IsEmpty())
+			{
+				InOutState.LastCommitSha = LocalSpread->CommitSha;
+				InOutState.LastCommitAuthor = LocalSpread->Author;
+			}
+		}
+		else if(InOutState.IsSourceControlled() && !InOutState.IsAdded())
+		{
+			Spread |= BaseSpread;
+		}
+	}
+
+	InOutState.LastCommitSpread = Spread;
+}
+
+void FGitSourceControlSpreadEngine::Reset()
+{
+	FScopeLock ScopeLock(&RefreshCriticalSection);
+	FWriteScopeLock WriteLock(Lock);
+	RefsSignature.Empty();
+	Spreads.Empty();
+	BaseSpread = ECommitSpread::Unknown;
+	bValid = false;
+}
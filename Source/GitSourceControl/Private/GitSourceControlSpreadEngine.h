@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeRWLock.h"
+#include "GitSourceControlState.h"
+
+class FGitSourceControlClaimIndex;
+
+/** Spread of the last commit of a file, computed from local refs */
+struct FGitLocalSpread
+{
+	/** Local and remote bits of the spread (LocalActiveBranch, LocalOtherBranch, RemoteMatchingBranch, RemoteOtherBranch) */
+	ECommitSpread Spread = ECommitSpread::Unknown;
+
+	/** Sha of the last commit for this file */
+	FString CommitSha;
+
+	/** Author of the last commit for this file */
+	FGitInternedString Author;
+};
+
+/**
+ * Compute locally the spread bits that can be derived from refs and commit history, for all files at once.
+ *
+ * Uses one "for-each-ref" to detect ref changes and categorize refs, one "merge-base" of each ref with HEAD,
+ * and a single "log --name-only" walk from all refs down to those merge bases.
+ * Gitalong is then only needed for the Clone* bits (other workstations), which come from the claim index.
+ * All methods are thread safe.
+ */
+class FGitSourceControlSpreadEngine
+{
+public:
+	/** Mask of the bits computed by this engine */
+	static constexpr ECommitSpread LocalSpreadMask = ECommitSpread::LocalActiveBranch | ECommitSpread::LocalOtherBranch | ECommitSpread::RemoteMatchingBranch | ECommitSpread::RemoteOtherBranch;
+
+	/** Mask of the bits that only Gitalong knows about */
+	static constexpr ECommitSpread CloneSpreadMask = ECommitSpread::CloneOtherBranch | ECommitSpread::CloneMatchingBranch | ECommitSpread::CloneUncommitted;
+
+	/**
+	 * Recompute the spread of all files if refs moved since the last refresh.
+	 * @returns true if the engine holds valid spread information
+	 */
+	bool Refresh(const FString& InPathToGitBinary, const FString& InRepositoryRoot, TArray<FString>& OutErrorMessages);
+
+	/** Combine local spread information with the Clone* bits of the claim index into the provided state */
+	void Apply(const FGitSourceControlClaimIndex& InClaimIndex, FGitSourceControlState& InOutState) const;
+
+	/** Forget everything */
+	void Reset();
+
+private:
+	/** Serialize refreshes */
+	FCriticalSection RefreshCriticalSection;
+
+	/** Output of the last "for-each-ref", to detect ref changes */
+	FString RefsSignature;
+
+	/** Spread of files changed since the merge bases of the refs with HEAD, by absolute filename */
+	TMap<FString, FGitLocalSpread> Spreads;
+
+	/** Spread of tracked files not changed since the merge bases of the refs with HEAD (all refs) */
+	ECommitSpread BaseSpread = ECommitSpread::Unknown;
+
+	/** Has a refresh succeeded */
+	bool bValid = false;
+
+	/** Lock for the spread information */
+	mutable FRWLock Lock;
+};
@@ -49,9 +49,10 @@ TSharedPtr<class ISourceControlRevision, ESPMode::ThreadSafe> FGitSourceControlS
 	for(const auto& Revision : History)
 	{
 		// support for short hashes
-		const int32 Len = FMath::Min(Revision->CommitId.Len(), InRevision.Len());
+		const FString& CommitId = Revision->Commit->CommitId;
+		const int32 Len = FMath::Min(CommitId.Len(), InRevision.Len());
 		
-		if(Revision->CommitId.Left(Len) == InRevision.Left(Len))
+		if(CommitId.Left(Len) == InRevision.Left(Len))
 		{
 			return Revision;
 		}
@@ -73,6 +74,11 @@ ISourceControlState::FResolveInfo FGitSourceControlState::GetResolveInfo() const
 #if SOURCE_CONTROL_WITH_SLATE
 
 FSlateIcon FGitSourceControlState::GetIcon() const
+{
+	return Presentation.Value.IsValid() ? Presentation.Value->Icon : ComputeIcon();
+}
+
+FSlateIcon FGitSourceControlState::ComputeIcon() const
 {
 	switch (WorkingCopyState)
 	{
@@ -116,8 +122,23 @@ FSlateIcon FGitSourceControlState::GetIcon() const
 
 #endif //SOURCE_CONTROL_WITH_SLATE
 
+void FGitSourceControlState::CachePresentation()
+{
+	TSharedRef<FPresentation, ESPMode::ThreadSafe> NewPresentation = MakeShared<FPresentation, ESPMode::ThreadSafe>();
+#if SOURCE_CONTROL_WITH_SLATE
+	NewPresentation->Icon = ComputeIcon();
+#endif //SOURCE_CONTROL_WITH_SLATE
+	NewPresentation->DisplayName = ComputeDisplayName();
+	NewPresentation->Tooltip = GetWorkingCopyTooltip();
+	Presentation.Value = NewPresentation;
+}
 
 FText FGitSourceControlState::GetDisplayName() const
+{
+	return Presentation.Value.IsValid() ? Presentation.Value->DisplayName : ComputeDisplayName();
+}
+
+FText FGitSourceControlState::ComputeDisplayName() const
 {
 	switch(WorkingCopyState)
 	{
@@ -172,6 +193,21 @@ FText FGitSourceControlState::GetDisplayName() const
 }
 
 FText FGitSourceControlState::GetDisplayTooltip() const
+{
+	const FText Tooltip = Presentation.Value.IsValid() ? Presentation.Value->Tooltip : GetWorkingCopyTooltip();
+
+	// Spread served from the last known claims while Gitalong is unreachable: tell how old it is
+	static const FTimespan StaleSpreadAge = FTimespan::FromMinutes(1.0);
+	const FTimespan SpreadAge = FDateTime::Now() - SpreadTimeStamp;
+	if(SpreadTimeStamp.GetTicks() > 0 && SpreadAge > StaleSpreadAge)
+	{
+		const int32 Minutes = FMath::FloorToInt32(SpreadAge.GetTotalMinutes());
+		return FText::Format(LOCTEXT("StaleSpread_Tooltip", "{0}\nGitalong is unreachable, claims as of {1} minute(s) ago."), Tooltip, FText::AsNumber(Minutes));
+	}
+	return Tooltip;
+}
+
+FText FGitSourceControlState::GetWorkingCopyTooltip() const
 {
 	switch(WorkingCopyState)
 	{
@@ -208,29 +244,29 @@ FText FGitSourceControlState::GetDisplayTooltip() const
 		{
 			if (LastCommitSha.IsEmpty())
 			{
-				return FText::Format(LOCTEXT("CheckedOutOther_Tooltip", "Missing uncommited changes by {0}."), FText::FromString(LastCommitAuthor));
+				return FText::Format(LOCTEXT("CheckedOutOther_Tooltip", "Missing uncommited changes by {0}."), FText::FromString(LastCommitAuthor.ToString()));
 			}
 			FString Branch;
 			if (LastCommitRemoteBranches.Num())
 			{
-				Branch = LastCommitRemoteBranches[0];
+				Branch = LastCommitRemoteBranches[0].ToString();
 			} else if (LastCommitLocalBranches.Num())
 			{
-				Branch = LastCommitLocalBranches[0];
+				Branch = LastCommitLocalBranches[0].ToString();
 			}
-			return FText::Format(LOCTEXT("CheckedOutInOtherBranch_Tooltip", "Missing commit {0} by {1} in {2} branch."), FText::FromString(LastCommitSha.Left(5)), FText::FromString(LastCommitAuthor), FText::FromString(Branch));
+			return FText::Format(LOCTEXT("CheckedOutInOtherBranch_Tooltip", "Missing commit {0} by {1} in {2} branch."), FText::FromString(LastCommitSha.Left(5)), FText::FromString(LastCommitAuthor.ToString()), FText::FromString(Branch));
 		}
 		if (IsCheckedOutInOtherBranch())
 		{
 			FString Branch;
 			if (LastCommitRemoteBranches.Num()) 
 			{
-				Branch = LastCommitRemoteBranches[0];
+				Branch = LastCommitRemoteBranches[0].ToString();
 			} else if (LastCommitLocalBranches.Num()) 
 			{
-				Branch = LastCommitLocalBranches[0];
+				Branch = LastCommitLocalBranches[0].ToString();
 			}
-			return FText::Format(LOCTEXT("CheckedOutInOtherBranch_Tooltip", "Missing commit {0} by {1} in {2} branch."), FText::FromString(LastCommitSha.Left(5)), FText::FromString(LastCommitAuthor), FText::FromString(Branch));
+			return FText::Format(LOCTEXT("CheckedOutInOtherBranch_Tooltip", "Missing commit {0} by {1} in {2} branch."), FText::FromString(LastCommitSha.Left(5)), FText::FromString(LastCommitAuthor.ToString()), FText::FromString(Branch));
 		}
 		if (!IsCurrent())
 		{
@@ -272,39 +308,12 @@ bool FGitSourceControlState::IsCheckedOut() const
 
 bool FGitSourceControlState::IsTruelyCheckedOut() const
 {
-	if (LastCommitSpread == ECommitSpread::Unknown) {
-		return false;
-	}
-	if (LastCommitSpread == ECommitSpread::LocalUncommitted)
-	{
-		return true;
-	}
-	if (LastCommitSpread == ECommitSpread::LocalActiveBranch)
-	{
-		return true;
-	}
-	
-	return false;
+	return GitSpreadPredicates::Is(LastCommitSpread, EGitSpreadPredicate::CheckedOut);
 }
 
 bool FGitSourceControlState::IsCheckedOutOther(FString* Who) const
 {
-	if (LastCommitSpread == ECommitSpread::Unknown) {
-		return false;
-	}
-	if (LastCommitSpread == ECommitSpread::CloneUncommitted)
-	{
-		return true;
-	}
-	const bool CloneMatchingBranch = (LastCommitSpread & ECommitSpread::CloneMatchingBranch) == ECommitSpread::CloneMatchingBranch;
-	const bool RemoteMatchingBranch = (LastCommitSpread & ECommitSpread::RemoteMatchingBranch) == ECommitSpread::RemoteMatchingBranch;
-
-	const bool RemoteOtherBranch = (LastCommitSpread & ECommitSpread::RemoteOtherBranch) == ECommitSpread::RemoteOtherBranch;
-	const bool LocalActiveBranch = (LastCommitSpread & ECommitSpread::LocalActiveBranch) == ECommitSpread::LocalActiveBranch;
-	const bool LocalOtherBranch = (LastCommitSpread & ECommitSpread::LocalOtherBranch) == ECommitSpread::LocalOtherBranch;
-	const bool CloneOtherBranch = (LastCommitSpread & ECommitSpread::CloneOtherBranch) == ECommitSpread::CloneOtherBranch;
-
-	return (CloneMatchingBranch && !RemoteMatchingBranch) || ((RemoteOtherBranch || LocalOtherBranch || CloneOtherBranch)  && !LocalActiveBranch);
+	return GitSpreadPredicates::Is(LastCommitSpread, EGitSpreadPredicate::CheckedOutOther);
 }
 
 // Unreal let us these file be saved because in the Perforce workflow checkouts are not exclusive across branches.
@@ -317,19 +326,9 @@ bool FGitSourceControlState::IsCheckedOutInOtherBranch(const FString& CurrentBra
 
 bool FGitSourceControlState::IsCurrent() const
 {
-	if (LastCommitSpread == ECommitSpread::Unknown) {
-		return true;
-	}
-	if (IsCheckedOut() || IsCheckedOutOther() || IsCheckedOutInOtherBranch())
-	{
-		// This seems paradoxical since if one on the above conditions is true you are not at the latest revision of the file, therefore not current.
-		// That said, because this method drives the visibility of the "Sync" right-click action in the editor,
-		// and because you cannot sync something that is in one of those state, we have to return true for these states.
-		return true;
-	}
-	const bool LocalUncommitted = (LastCommitSpread & ECommitSpread::LocalUncommitted) == ECommitSpread::LocalUncommitted;
-	const bool LocalActiveBranch = (LastCommitSpread & ECommitSpread::LocalActiveBranch) == ECommitSpread::LocalActiveBranch;
-	return (LocalUncommitted || LocalActiveBranch);
+	// Checked out files are reported as current: this seems paradoxical since you are not at the latest revision of the file,
+	// but this method drives the visibility of the "Sync" right-click action in the editor, and you cannot sync a file in one of those states.
+	return GitSpreadPredicates::Is(LastCommitSpread, EGitSpreadPredicate::Current);
 }
 
 bool FGitSourceControlState::IsSourceControlled() const
@@ -6,6 +6,10 @@
 #include "ISourceControlState.h"
 #include "ISourceControlRevision.h"
 #include "GitSourceControlRevision.h"
+#include "GitSourceControlStringTable.h"
+#if SOURCE_CONTROL_WITH_SLATE
+#include "Textures/SlateIcon.h"
+#endif //SOURCE_CONTROL_WITH_SLATE
 
 namespace EWorkingCopyState
 {
@@ -40,6 +44,79 @@ enum class ECommitSpread: uint8
 };
 ENUM_CLASS_FLAGS(ECommitSpread);
 
+/** Predicates of a commit spread, precomputed for each of its 256 values */
+enum class EGitSpreadPredicate : uint8
+{
+	None = 0,
+	/** The last commit is local: uncommitted, or only in the active branch */
+	CheckedOut = 1 << 0,
+	/** The last commit is from another clone or another branch */
+	CheckedOutOther = 1 << 1,
+	/** No missing commit to sync */
+	Current = 1 << 2,
+};
+ENUM_CLASS_FLAGS(EGitSpreadPredicate)
+
+namespace GitSpreadPredicates
+{
+	constexpr uint8 Compute(uint8 InSpread)
+	{
+		if(InSpread == (uint8)ECommitSpread::Unknown)
+		{
+			return (uint8)EGitSpreadPredicate::Current;
+		}
+		const auto Has = [InSpread](ECommitSpread InFlag) { return (InSpread & (uint8)InFlag) != 0; };
+		const bool bCheckedOut = InSpread == (uint8)ECommitSpread::LocalUncommitted || InSpread == (uint8)ECommitSpread::LocalActiveBranch;
+		const bool bCheckedOutOther = InSpread == (uint8)ECommitSpread::CloneUncommitted
+			|| (Has(ECommitSpread::CloneMatchingBranch) && !Has(ECommitSpread::RemoteMatchingBranch))
+			|| ((Has(ECommitSpread::RemoteOtherBranch) || Has(ECommitSpread::LocalOtherBranch) || Has(ECommitSpread::CloneOtherBranch)) && !Has(ECommitSpread::LocalActiveBranch));
+		// Checked out files are reported as current, since they cannot be synced (see FGitSourceControlState::IsCurrent)
+		const bool bCurrent = bCheckedOut || bCheckedOutOther || Has(ECommitSpread::LocalUncommitted) || Has(ECommitSpread::LocalActiveBranch);
+		return (bCheckedOut ? (uint8)EGitSpreadPredicate::CheckedOut : 0)
+			| (bCheckedOutOther ? (uint8)EGitSpreadPredicate::CheckedOutOther : 0)
+			| (bCurrent ? (uint8)EGitSpreadPredicate::Current : 0);
+	}
+
+	struct FTable
+	{
+		uint8 Predicates[256] = {};
+
+		constexpr FTable()
+		{
+			for(int32 Spread = 0; Spread < 256; Spread++)
+			{
+				Predicates[Spread] = Compute((uint8)Spread);
+			}
+		}
+	};
+
+	inline constexpr FTable Table;
+
+	/** Whether a spread satisfies a predicate, with a single table lookup */
+	FORCEINLINE bool Is(ECommitSpread InSpread, EGitSpreadPredicate InPredicate)
+	{
+		return (Table.Predicates[(uint8)InSpread] & (uint8)InPredicate) != 0;
+	}
+}
+
+/** Secondary indices of the state cache, for predicate queries answered in time proportional to their result */
+enum class EGitStateIndex : uint8
+{
+	None = 0,
+	/** Local changes: IsModified() (which includes added, deleted and conflicted files) */
+	Modified = 1 << 0,
+	Added = 1 << 1,
+	Deleted = 1 << 2,
+	Conflicted = 1 << 3,
+	/** IsCheckedOut() */
+	CheckedOut = 1 << 4,
+	/** IsCheckedOutOther() */
+	CheckedOutOther = 1 << 5,
+	/** !IsCurrent() */
+	NotCurrent = 1 << 6,
+};
+ENUM_CLASS_FLAGS(EGitStateIndex)
+
 class FGitSourceControlState : public ISourceControlState
 {
 public:
@@ -49,8 +126,7 @@ public:
 		, TimeStamp(0)
 		, LastCommitSpread(ECommitSpread::Unknown)
 		, LastCommitSha("")
-		, LastCommitHost("")
-		, LastCommitAuthor("")
+		, SpreadTimeStamp(0)
 	{
 	}
 
@@ -98,6 +174,36 @@ public:
 	virtual bool IsConflicted() const override;
 	virtual bool CanRevert() const override;
 
+	/** Icon and texts shown by the Editor for a state */
+	struct FPresentation
+	{
+#if SOURCE_CONTROL_WITH_SLATE
+		FSlateIcon Icon;
+#endif //SOURCE_CONTROL_WITH_SLATE
+		FText DisplayName;
+		/** Tooltip of the working copy state and spread, without the age of a stale spread */
+		FText Tooltip;
+	};
+
+	/**
+	 * Compute the presentation of the state once, so that painting it does no string work.
+	 * Called by the state cache when it publishes the state: the presentation is not copied along with the state, since copies are made to be modified.
+	 */
+	void CachePresentation();
+
+	typedef TSharedPtr<const FPresentation, ESPMode::ThreadSafe> FPresentationPtr;
+
+	/** Presentation computed by CachePresentation(), kept by the state cache to share it with the states it builds again from the same fields */
+	FPresentationPtr GetPresentation() const
+	{
+		return Presentation.Value;
+	}
+
+	void SetPresentation(const FPresentationPtr& InPresentation)
+	{
+		Presentation.Value = InPresentation;
+	}
+
 public:
 	/** History of the item, if any */
 	TGitSourceControlHistory History;
@@ -124,14 +230,37 @@ public:
 	FString LastCommitSha;
 
 	/** List of local branch names where the last commit for this file lives.. */
-	TArray<FString> LastCommitLocalBranches;
+	TArray<FGitInternedString> LastCommitLocalBranches;
 
 	/** List of remote branch names where the last commit for this file lives.. */
-	TArray<FString> LastCommitRemoteBranches;
+	TArray<FGitInternedString> LastCommitRemoteBranches;
 	
 	/** Hostname for the last commit of this file. */
-	FString LastCommitHost;
+	FGitInternedString LastCommitHost;
 	
 	/** Author or user for the last commit of this file. */
-	FString LastCommitAuthor;
+	FGitInternedString LastCommitAuthor;
+
+	/** When the Gitalong spread information served from the claim journal while offline was fetched, zero for live spread information */
+	FDateTime SpreadTimeStamp;
+
+private:
+	/** Tooltip describing the working copy state and the spread of the file */
+	FText GetWorkingCopyTooltip() const;
+
+#if SOURCE_CONTROL_WITH_SLATE
+	FSlateIcon ComputeIcon() const;
+#endif //SOURCE_CONTROL_WITH_SLATE
+	FText ComputeDisplayName() const;
+
+	/** Shared presentation, dropped by copies and moves */
+	struct FCachedPresentation
+	{
+		FCachedPresentation() = default;
+		FCachedPresentation(const FCachedPresentation&) {}
+		FCachedPresentation& operator=(const FCachedPresentation&) { Value.Reset(); return *this; }
+
+		FPresentationPtr Value;
+	};
+	FCachedPresentation Presentation;
 };
@@ -0,0 +1,724 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlStateCache.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeTryLock.h"
+#include "GitSourceControlRevision.h"
+
+static bool HasResolveInfo(const FResolveInfo& InResolveInfo)
+{
+	return !InResolveInfo.BaseFile.IsEmpty() || !InResolveInfo.BaseRevision.IsEmpty() || !InResolveInfo.RemoteFile.IsEmpty() || !InResolveInfo.RemoteRevision.IsEmpty();
+}
+
+void FGitSourceControlStateCache::SetRepositoryRoot(const FString& InRepositoryRoot)
+{
+	if(!RepositoryRoot.Equals(InRepositoryRoot, ESearchCase::IgnoreCase))
+	{
+		// keys are relative to the previous root
+		Empty();
+		RepositoryRoot = InRepositoryRoot;
+	}
+}
+
+bool FGitSourceControlStateCache::IsNormalized(FStringView InFilename) const
+{
+	const int32 RootLen = RepositoryRoot.Len();
+	if(RootLen == 0 || InFilename.Len() <= RootLen + 1 || InFilename[RootLen] != TEXT('/') || !InFilename.StartsWith(RepositoryRoot, ESearchCase::IgnoreCase))
+	{
+		return false;
+	}
+	// no backslash, and no empty, "." or ".." folder in the relative path
+	int32 SegmentStart = RootLen + 1;
+	for(int32 Index = SegmentStart; Index <= InFilename.Len(); Index++)
+	{
+		const TCHAR Char = Index < InFilename.Len() ? InFilename[Index] : TEXT('/');
+		if(Char == TEXT('\\'))
+		{
+			return false;
+		}
+		if(Char == TEXT('/'))
+		{
+			const FStringView Segment = InFilename.Mid(SegmentStart, Index - SegmentStart);
+			if(Segment.IsEmpty() || Segment == TEXT(".") || Segment == TEXT(".."))
+			{
+				return false;
+			}
+			SegmentStart = Index + 1;
+		}
+	}
+	return true;
+}
+
+void FGitSourceControlStateCache::MakeKey(FStringView InFilename, FKey& OutKey) const
+{
+	FStringView Filename = InFilename;
+	if(!IsNormalized(Filename))
+	{
+		OutKey.Storage = FPaths::ConvertRelativePathToFull(FString(InFilename));
+		Filename = OutKey.Storage;
+	}
+	if(IsNormalized(Filename))
+	{
+		Filename.RightChopInline(RepositoryRoot.Len() + 1);
+	}
+	OutKey.Path = Filename;
+	OutKey.Hash = GetPathHash(Filename);
+}
+
+FString FGitSourceControlStateCache::ToFilename(FStringView InPath) const
+{
+	// keys of files outside of the repository are their absolute filename
+	const bool bAbsolute = InPath.StartsWith(TEXT('/')) || (InPath.Len() > 1 && InPath[1] == TEXT(':'));
+	if(bAbsolute || RepositoryRoot.IsEmpty())
+	{
+		return FString(InPath);
+	}
+	FString Filename;
+	Filename.Reserve(RepositoryRoot.Len() + 1 + InPath.Len());
+	Filename.Append(RepositoryRoot);
+	Filename.AppendChar(TEXT('/'));
+	Filename.Append(InPath);
+	return Filename;
+}
+
+FGitSourceControlStateCache::FStateRef FGitSourceControlStateCache::Build(const FShard& InShard, int32 InRow, FStringView InPath) const
+{
+	FStateRef State = MakeShared<FGitSourceControlState, ESPMode::ThreadSafe>(ToFilename(InPath));
+	State->WorkingCopyState = (EWorkingCopyState::Type)InShard.WorkingCopyStates[InRow];
+	State->LastCommitSpread = InShard.Spreads[InRow];
+	const FString* OtherSha = InShard.OtherShas.Find(InRow);
+	State->LastCommitSha = OtherSha ? *OtherSha : FromShaHash(InShard.Shas[InRow]);
+	State->LastCommitAuthor = InShard.Authors[InRow];
+	State->LastCommitHost = InShard.Hosts[InRow];
+	FGitSourceControlStringTable& StringTable = FGitSourceControlStringTable::Get();
+	State->LastCommitLocalBranches = StringTable.ResolveList(InShard.LocalBranchesIds[InRow]);
+	State->LastCommitRemoteBranches = StringTable.ResolveList(InShard.RemoteBranchesIds[InRow]);
+	State->TimeStamp = FDateTime(InShard.TimeStamps[InRow]);
+	State->SpreadTimeStamp = FDateTime(InShard.SpreadTimeStamps[InRow]);
+	if(const FHistoryEntry* History = InShard.Histories.Find(InRow))
+	{
+		State->History = History->History;
+		Touch(*History);
+	}
+	if(const FResolveInfo* ResolveInfo = InShard.ResolveInfos.Find(InRow))
+	{
+		State->PendingResolveInfo = *ResolveInfo;
+	}
+	State->SetPresentation(InShard.Presentations[InRow]);
+	return State;
+}
+
+FGitSourceControlStateCache::FStateRef FGitSourceControlStateCache::Materialize(const FShard& InShard, int32 InRow, FStringView InPath) const
+{
+	FScopeLock ScopeLock(&InShard.MaterializedCriticalSection);
+	TWeakPtr<FGitSourceControlState, ESPMode::ThreadSafe>& Weak = InShard.Materialized.FindOrAdd(InRow);
+	if(const FStatePtr Shared = Weak.Pin())
+	{
+		if(Shared->History.Num() > 0)
+		{
+			if(const FHistoryEntry* History = InShard.Histories.Find(InRow))
+			{
+				Touch(*History);
+			}
+		}
+		return Shared.ToSharedRef();
+	}
+
+	const FStateRef State = Build(InShard, InRow, InPath);
+	Weak = State;
+	Pin(InShard, State);
+
+	// forget states no caller holds anymore, before they outnumber the live ones
+	if(InShard.Materialized.Num() >= InShard.MaterializedPurgeThreshold)
+	{
+		for(auto It = InShard.Materialized.CreateIterator(); It; ++It)
+		{
+			if(!It.Value().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		InShard.MaterializedPurgeThreshold = FMath::Max(64, 2 * InShard.Materialized.Num());
+	}
+	return State;
+}
+
+const FGitSourceControlState::FPresentationPtr& FGitSourceControlStateCache::GetUnknownPresentation()
+{
+	static const FGitSourceControlState::FPresentationPtr UnknownPresentation = []()
+	{
+		FGitSourceControlState UnknownState{FString()};
+		UnknownState.CachePresentation();
+		return UnknownState.GetPresentation();
+	}();
+	return UnknownPresentation;
+}
+
+void FGitSourceControlStateCache::Pin(const FShard& InShard, const FStateRef& InState)
+{
+	if(InShard.Pinned.Num() < NumPinnedPerShard)
+	{
+		InShard.Pinned.Add(InState);
+		return;
+	}
+	InShard.Pinned[InShard.NextPinned] = InState;
+	InShard.NextPinned = (InShard.NextPinned + 1) % NumPinnedPerShard;
+}
+
+void FGitSourceControlStateCache::Forget(const FShard& InShard, int32 InRow)
+{
+	FScopeLock ScopeLock(&InShard.MaterializedCriticalSection);
+	TWeakPtr<FGitSourceControlState, ESPMode::ThreadSafe> Weak;
+	if(InShard.Materialized.RemoveAndCopyValue(InRow, Weak))
+	{
+		if(const FStatePtr Shared = Weak.Pin())
+		{
+			for(FStatePtr& Pinned : InShard.Pinned)
+			{
+				if(Pinned == Shared)
+				{
+					Pinned.Reset();
+				}
+			}
+		}
+	}
+}
+
+int32 FGitSourceControlStateCache::AddRow(FShard& InShard, const FKey& InKey, const FString& InFilename)
+{
+	int32 Row;
+	if(InShard.FreeRows.Num() > 0)
+	{
+		Row = InShard.FreeRows.Pop(EAllowShrinking::No);
+		InShard.WorkingCopyStates[Row] = EWorkingCopyState::Unknown;
+		InShard.Spreads[Row] = ECommitSpread::Unknown;
+		InShard.Shas[Row] = FSHAHash();
+		InShard.Authors[Row] = FGitInternedString();
+		InShard.Hosts[Row] = FGitInternedString();
+		InShard.LocalBranchesIds[Row] = 0;
+		InShard.RemoteBranchesIds[Row] = 0;
+		InShard.TimeStamps[Row] = 0;
+		InShard.SpreadTimeStamps[Row] = 0;
+		InShard.RowIndices[Row] = EGitStateIndex::None;
+		InShard.Presentations[Row] = GetUnknownPresentation();
+	}
+	else
+	{
+		Row = InShard.WorkingCopyStates.Add(EWorkingCopyState::Unknown);
+		InShard.Spreads.Add(ECommitSpread::Unknown);
+		InShard.Shas.AddDefaulted();
+		InShard.Authors.AddDefaulted();
+		InShard.Hosts.AddDefaulted();
+		InShard.LocalBranchesIds.Add(0);
+		InShard.RemoteBranchesIds.Add(0);
+		InShard.TimeStamps.Add(0);
+		InShard.SpreadTimeStamps.Add(0);
+		InShard.RowIndices.Add(EGitStateIndex::None);
+		InShard.Presentations.Add(GetUnknownPresentation());
+	}
+	InShard.Rows.AddByHash(InKey.Hash, FString(InKey.Path), Row);
+	PathTrie.Add(InFilename, EGitStateIndex::None, ECommitSpread::Unknown);
+	return Row;
+}
+
+void FGitSourceControlStateCache::Store(FShard& InShard, int32 InRow, FStringView InPath, const FGitSourceControlState& InState)
+{
+	const ECommitSpread OldSpread = InShard.Spreads[InRow];
+	const EGitStateIndex OldIndices = InShard.RowIndices[InRow];
+	InShard.WorkingCopyStates[InRow] = (uint8)InState.WorkingCopyState;
+	InShard.Spreads[InRow] = InState.LastCommitSpread;
+	InShard.Shas[InRow] = ToShaHash(InState.LastCommitSha);
+	if(InShard.Shas[InRow] == FSHAHash() && !InState.LastCommitSha.IsEmpty())
+	{
+		InShard.OtherShas.Add(InRow, InState.LastCommitSha);
+	}
+	else
+	{
+		InShard.OtherShas.Remove(InRow);
+	}
+	InShard.Authors[InRow] = InState.LastCommitAuthor;
+	InShard.Hosts[InRow] = InState.LastCommitHost;
+	FGitSourceControlStringTable& StringTable = FGitSourceControlStringTable::Get();
+	InShard.LocalBranchesIds[InRow] = StringTable.InternList(InState.LastCommitLocalBranches);
+	InShard.RemoteBranchesIds[InRow] = StringTable.InternList(InState.LastCommitRemoteBranches);
+	InShard.TimeStamps[InRow] = InState.TimeStamp.GetTicks();
+	InShard.SpreadTimeStamps[InRow] = InState.SpreadTimeStamp.GetTicks();
+	InShard.Presentations[InRow] = InState.GetPresentation();
+	Reindex(InShard, InRow, InPath, GetPathHash(InPath), GetIndices(InState));
+	PathTrie.Update(InState.LocalFilename, OldIndices, OldSpread, InShard.RowIndices[InRow], InState.LastCommitSpread);
+	FHistoryEntry* History = InShard.Histories.Find(InRow);
+	if(InState.History.Num() > 0)
+	{
+		if(History == nullptr)
+		{
+			History = &InShard.Histories.Add(InRow);
+		}
+		if(History->History != InState.History)
+		{
+			const int64 Size = GetHistorySize(InState.History);
+			HistoryBytes += Size - History->Size;
+			History->History = InState.History;
+			History->Size = Size;
+		}
+		Touch(*History);
+	}
+	else if(History != nullptr)
+	{
+		HistoryBytes -= History->Size;
+		InShard.Histories.Remove(InRow);
+	}
+	if(HasResolveInfo(InState.PendingResolveInfo))
+	{
+		InShard.ResolveInfos.Add(InRow, InState.PendingResolveInfo);
+	}
+	else
+	{
+		InShard.ResolveInfos.Remove(InRow);
+	}
+}
+
+void FGitSourceControlStateCache::Reindex(FShard& InShard, int32 InRow, FStringView InPath, uint32 InHash, EGitStateIndex InIndices)
+{
+	const EGitStateIndex OldIndices = InShard.RowIndices[InRow];
+	if(OldIndices == InIndices)
+	{
+		return;
+	}
+	for(int32 Index = 0; Index < NumIndices; Index++)
+	{
+		const EGitStateIndex Flag = (EGitStateIndex)(1 << Index);
+		if(EnumHasAnyFlags(OldIndices, Flag) && !EnumHasAnyFlags(InIndices, Flag))
+		{
+			InShard.Indices[Index].RemoveByHash(InHash, InPath);
+		}
+		else if(!EnumHasAnyFlags(OldIndices, Flag) && EnumHasAnyFlags(InIndices, Flag))
+		{
+			InShard.Indices[Index].AddByHash(InHash, FString(InPath));
+		}
+	}
+	InShard.RowIndices[InRow] = InIndices;
+}
+
+EGitStateIndex FGitSourceControlStateCache::GetIndices(const FGitSourceControlState& InState)
+{
+	EGitStateIndex Indices = EGitStateIndex::None;
+	if(InState.IsModified())
+	{
+		Indices |= EGitStateIndex::Modified;
+	}
+	if(InState.IsAdded())
+	{
+		Indices |= EGitStateIndex::Added;
+	}
+	if(InState.IsDeleted())
+	{
+		Indices |= EGitStateIndex::Deleted;
+	}
+	if(InState.IsConflicted())
+	{
+		Indices |= EGitStateIndex::Conflicted;
+	}
+	if(InState.IsCheckedOut())
+	{
+		Indices |= EGitStateIndex::CheckedOut;
+	}
+	if(InState.IsCheckedOutOther())
+	{
+		Indices |= EGitStateIndex::CheckedOutOther;
+	}
+	if(!InState.IsCurrent())
+	{
+		Indices |= EGitStateIndex::NotCurrent;
+	}
+	return Indices;
+}
+
+FGitSourceControlStateCache::FStateRef FGitSourceControlStateCache::FindOrAdd(FStringView InFilename)
+{
+	FKey Key;
+	MakeKey(InFilename, Key);
+	if(const FStatePtr State = FindInternal(Key))
+	{
+		// found cached item
+		return State.ToSharedRef();
+	}
+
+	// cache an unknown state for this item (unless another thread just did)
+	FShard& Shard = GetShard(Key);
+	const FString Filename = ToFilename(Key.Path);
+	FWriteScopeLock WriteLock(Shard.Lock);
+	const int32* Row = Shard.Rows.FindByHash(Key.Hash, Key.Path);
+	return Materialize(Shard, Row ? *Row : AddRow(Shard, Key, Filename), Key.Path);
+}
+
+FGitSourceControlStateCache::FStatePtr FGitSourceControlStateCache::Find(FStringView InFilename) const
+{
+	FKey Key;
+	MakeKey(InFilename, Key);
+	return FindInternal(Key);
+}
+
+void FGitSourceControlStateCache::Find(TConstArrayView<FString> InFilenames, TArray<FStatePtr>& OutStates) const
+{
+	OutStates.Reset(InFilenames.Num());
+	for(const FString& Filename : InFilenames)
+	{
+		FKey Key;
+		MakeKey(Filename, Key);
+		OutStates.Add(FindInternal(Key));
+	}
+}
+
+FGitSourceControlStateCache::FStatePtr FGitSourceControlStateCache::FindInternal(const FKey& InKey) const
+{
+	const FShard& Shard = GetShard(InKey);
+	FReadScopeLock ReadLock(Shard.Lock);
+	if(const int32* Row = Shard.Rows.FindByHash(InKey.Hash, InKey.Path))
+	{
+		return Materialize(Shard, *Row, InKey.Path);
+	}
+	return nullptr;
+}
+
+FGitSourceControlStateCache::FStatePtr FGitSourceControlStateCache::Update(FStringView InFilename, TFunctionRef<bool(FGitSourceControlState&)> InUpdate)
+{
+	FKey Key;
+	MakeKey(InFilename, Key);
+	FShard& Shard = GetShard(Key);
+	FStatePtr NewState;
+	EGitStateFields ChangedFields;
+	{
+		FWriteScopeLock WriteLock(Shard.Lock);
+		const int32* FoundRow = Shard.Rows.FindByHash(Key.Hash, Key.Path);
+		const FStateRef OldState = FoundRow ? Materialize(Shard, *FoundRow, Key.Path) : MakeShared<FGitSourceControlState, ESPMode::ThreadSafe>(ToFilename(Key.Path));
+		NewState = MakeShared<FGitSourceControlState, ESPMode::ThreadSafe>(*OldState);
+		if(!InUpdate(*NewState))
+		{
+			return nullptr;
+		}
+		NewState->CachePresentation();
+		const int32 Row = FoundRow ? *FoundRow : AddRow(Shard, Key, NewState->LocalFilename);
+		Store(Shard, Row, Key.Path, *NewState);
+		{
+			// callers asking for this file from now on share the new state
+			FScopeLock ScopeLock(&Shard.MaterializedCriticalSection);
+			Shard.Materialized.Add(Row, NewState);
+			Pin(Shard, NewState.ToSharedRef());
+		}
+		ChangedFields = GetChangedFields(*OldState, *NewState);
+	}
+	if(ChangedFields != EGitStateFields::None)
+	{
+		AddChange(NewState->LocalFilename, ChangedFields);
+	}
+	if(HistoryBudget > 0 && HistoryBytes > HistoryBudget)
+	{
+		TrimHistories();
+	}
+	return NewState;
+}
+
+bool FGitSourceControlStateCache::Remove(FStringView InFilename)
+{
+	FKey Key;
+	MakeKey(InFilename, Key);
+	FShard& Shard = GetShard(Key);
+	const FString Filename = ToFilename(Key.Path);
+	{
+		FWriteScopeLock WriteLock(Shard.Lock);
+		const int32* FoundRow = Shard.Rows.FindByHash(Key.Hash, Key.Path);
+		if(FoundRow == nullptr)
+		{
+			return false;
+		}
+		const int32 Row = *FoundRow;
+		if(const FHistoryEntry* History = Shard.Histories.Find(Row))
+		{
+			HistoryBytes -= History->Size;
+		}
+		PathTrie.Remove(Filename, Shard.RowIndices[Row], Shard.Spreads[Row]);
+		Reindex(Shard, Row, Key.Path, Key.Hash, EGitStateIndex::None);
+		Shard.Rows.RemoveByHash(Key.Hash, Key.Path);
+		Shard.Histories.Remove(Row);
+		Shard.ResolveInfos.Remove(Row);
+		Shard.OtherShas.Remove(Row);
+		Forget(Shard, Row);
+		Shard.FreeRows.Add(Row);
+	}
+	AddChange(Filename, EGitStateFields::Removed);
+	return true;
+}
+
+void FGitSourceControlStateCache::Empty()
+{
+	for(FShard& Shard : Shards)
+	{
+		FWriteScopeLock WriteLock(Shard.Lock);
+		Shard.Rows.Empty();
+		Shard.FreeRows.Empty();
+		Shard.WorkingCopyStates.Empty();
+		Shard.Spreads.Empty();
+		Shard.Shas.Empty();
+		Shard.Authors.Empty();
+		Shard.Hosts.Empty();
+		Shard.LocalBranchesIds.Empty();
+		Shard.RemoteBranchesIds.Empty();
+		Shard.TimeStamps.Empty();
+		Shard.SpreadTimeStamps.Empty();
+		Shard.RowIndices.Empty();
+		Shard.Presentations.Empty();
+		for(TSet<FString, FPathSetKeyFuncs>& Index : Shard.Indices)
+		{
+			Index.Empty();
+		}
+		Shard.Histories.Empty();
+		Shard.ResolveInfos.Empty();
+		Shard.OtherShas.Empty();
+		FScopeLock ScopeLock(&Shard.MaterializedCriticalSection);
+		Shard.Materialized.Empty();
+		Shard.Pinned.Empty();
+		Shard.NextPinned = 0;
+	}
+	PathTrie.Empty();
+	HistoryBytes = 0;
+	FScopeLock ScopeLock(&ChangesCriticalSection);
+	Changes.Empty();
+}
+
+int64 FGitSourceControlStateCache::GetHistorySize(const TGitSourceControlHistory& InHistory)
+{
+	int64 Size = InHistory.GetAllocatedSize();
+	for(const TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe>& Revision : InHistory)
+	{
+		// commits are shared with the histories of other files: not counted
+		Size += sizeof(FGitSourceControlRevision) + Revision->Filename.GetAllocatedSize() + Revision->FileHash.GetAllocatedSize() + Revision->Action.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FGitSourceControlStateCache::Touch(const FHistoryEntry& InEntry) const
+{
+	FPlatformAtomics::AtomicStore_Relaxed(&InEntry.LastUse, ++HistoryClock);
+}
+
+void FGitSourceControlStateCache::TrimHistories()
+{
+	// a single thread trims at a time, for all the histories published meanwhile
+	FScopeTryLock TryLock(&TrimCriticalSection);
+	if(!TryLock.IsLocked())
+	{
+		return;
+	}
+
+	struct FCandidate
+	{
+		int64 LastUse;
+		int32 Shard;
+		int32 Row;
+	};
+	TArray<FCandidate> Candidates;
+	for(int32 ShardIndex = 0; ShardIndex < NumShards; ShardIndex++)
+	{
+		const FShard& Shard = Shards[ShardIndex];
+		FReadScopeLock ReadLock(Shard.Lock);
+		for(const auto& History : Shard.Histories)
+		{
+			Candidates.Add({FPlatformAtomics::AtomicRead_Relaxed(&History.Value.LastUse), ShardIndex, History.Key});
+		}
+	}
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.LastUse < B.LastUse; });
+
+	// go well below the budget so that trims stay rare
+	const int64 Target = HistoryBudget * 3 / 4;
+	for(const FCandidate& Candidate : Candidates)
+	{
+		if(HistoryBytes <= Target)
+		{
+			break;
+		}
+		FShard& Shard = Shards[Candidate.Shard];
+		FWriteScopeLock WriteLock(Shard.Lock);
+		const FHistoryEntry* History = Shard.Histories.Find(Candidate.Row);
+		if(History == nullptr || History->LastUse != Candidate.LastUse)
+		{
+			// replaced, removed or used again since
+			continue;
+		}
+		HistoryBytes -= History->Size;
+		Shard.Histories.Remove(Candidate.Row);
+		// the next callers get a state without history; current holders keep theirs until they release it
+		Forget(Shard, Candidate.Row);
+	}
+}
+
+int32 FGitSourceControlStateCache::Num() const
+{
+	int32 Num = 0;
+	for(const FShard& Shard : Shards)
+	{
+		FReadScopeLock ReadLock(Shard.Lock);
+		Num += Shard.Rows.Num();
+	}
+	return Num;
+}
+
+SIZE_T FGitSourceControlStateCache::GetAllocatedSize() const
+{
+	SIZE_T Size = PathTrie.GetAllocatedSize();
+	for(const FShard& Shard : Shards)
+	{
+		FReadScopeLock ReadLock(Shard.Lock);
+		Size += Shard.Rows.GetAllocatedSize() + Shard.FreeRows.GetAllocatedSize();
+		for(const auto& Item : Shard.Rows)
+		{
+			Size += Item.Key.GetAllocatedSize();
+		}
+		Size += Shard.WorkingCopyStates.GetAllocatedSize() + Shard.Spreads.GetAllocatedSize();
+		Size += Shard.Shas.GetAllocatedSize() + Shard.Authors.GetAllocatedSize() + Shard.Hosts.GetAllocatedSize();
+		Size += Shard.LocalBranchesIds.GetAllocatedSize() + Shard.RemoteBranchesIds.GetAllocatedSize();
+		Size += Shard.TimeStamps.GetAllocatedSize() + Shard.SpreadTimeStamps.GetAllocatedSize();
+		Size += Shard.RowIndices.GetAllocatedSize() + Shard.Presentations.GetAllocatedSize();
+		for(const TSet<FString, FPathSetKeyFuncs>& Index : Shard.Indices)
+		{
+			Size += Index.GetAllocatedSize();
+			for(const FString& Filename : Index)
+			{
+				Size += Filename.GetAllocatedSize();
+			}
+		}
+		Size += Shard.Histories.GetAllocatedSize() + Shard.ResolveInfos.GetAllocatedSize();
+		for(const auto& History : Shard.Histories)
+		{
+			Size += History.Value.History.GetAllocatedSize();
+		}
+		Size += Shard.OtherShas.GetAllocatedSize();
+		for(const auto& OtherSha : Shard.OtherShas)
+		{
+			Size += OtherSha.Value.GetAllocatedSize();
+		}
+		FScopeLock ScopeLock(&Shard.MaterializedCriticalSection);
+		Size += Shard.Materialized.GetAllocatedSize() + Shard.Pinned.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FGitSourceControlStateCache::ForEach(TFunctionRef<void(const FStateRef&)> InFunction) const
+{
+	for(const FShard& Shard : Shards)
+	{
+		FReadScopeLock ReadLock(Shard.Lock);
+		for(const auto& Item : Shard.Rows)
+		{
+			InFunction(Materialize(Shard, Item.Value, Item.Key));
+		}
+	}
+}
+
+int32 FGitSourceControlStateCache::Num(EGitStateIndex InIndex) const
+{
+	const int32 Index = FMath::FloorLog2((uint32)InIndex);
+	check(InIndex != EGitStateIndex::None && Index < NumIndices);
+	int32 Num = 0;
+	for(const FShard& Shard : Shards)
+	{
+		FReadScopeLock ReadLock(Shard.Lock);
+		Num += Shard.Indices[Index].Num();
+	}
+	return Num;
+}
+
+void FGitSourceControlStateCache::ForEach(EGitStateIndex InIndices, TFunctionRef<void(const FStateRef&)> InFunction) const
+{
+	for(const FShard& Shard : Shards)
+	{
+		FReadScopeLock ReadLock(Shard.Lock);
+		for(int32 Index = 0; Index < NumIndices; Index++)
+		{
+			const EGitStateIndex Flag = (EGitStateIndex)(1 << Index);
+			if(!EnumHasAnyFlags(InIndices, Flag))
+			{
+				continue;
+			}
+			for(const FString& Path : Shard.Indices[Index])
+			{
+				const int32 Row = Shard.Rows.FindChecked(Path);
+				// a file in several of the requested indices is only visited from the first one
+				if(((uint8)Shard.RowIndices[Row] & (uint8)InIndices & ((1 << Index) - 1)) == 0)
+				{
+					InFunction(Materialize(Shard, Row, Path));
+				}
+			}
+		}
+	}
+}
+
+bool FGitSourceControlStateCache::ConsumeChanges(FGitSourceControlStateDelta& OutDelta)
+{
+	FScopeLock ScopeLock(&ChangesCriticalSection);
+	if(Changes.Num() == 0)
+	{
+		return false;
+	}
+	OutDelta = MoveTemp(Changes);
+	Changes.Reset();
+	return true;
+}
+
+EGitStateFields FGitSourceControlStateCache::GetChangedFields(const FGitSourceControlState& InOldState, const FGitSourceControlState& InNewState)
+{
+	EGitStateFields Fields = EGitStateFields::None;
+	if(InOldState.WorkingCopyState != InNewState.WorkingCopyState || InOldState.PendingResolveInfo.BaseRevision != InNewState.PendingResolveInfo.BaseRevision)
+	{
+		Fields |= EGitStateFields::WorkingCopy;
+	}
+	if(InOldState.LastCommitSpread != InNewState.LastCommitSpread)
+	{
+		Fields |= EGitStateFields::Spread;
+	}
+	if(InOldState.LastCommitSha != InNewState.LastCommitSha || InOldState.LastCommitHost != InNewState.LastCommitHost || InOldState.LastCommitAuthor != InNewState.LastCommitAuthor
+		|| InOldState.LastCommitLocalBranches != InNewState.LastCommitLocalBranches || InOldState.LastCommitRemoteBranches != InNewState.LastCommitRemoteBranches)
+	{
+		Fields |= EGitStateFields::LastCommit;
+	}
+	// revisions are shared between states: comparing the pointers is enough
+	if(InOldState.History != InNewState.History || InOldState.TimeStamp != InNewState.TimeStamp)
+	{
+		Fields |= EGitStateFields::History;
+	}
+	if(InOldState.SpreadTimeStamp != InNewState.SpreadTimeStamp)
+	{
+		Fields |= EGitStateFields::SpreadTimeStamp;
+	}
+	return Fields;
+}
+
+FSHAHash FGitSourceControlStateCache::ToShaHash(const FString& InSha)
+{
+	FSHAHash Hash;
+	if(InSha.Len() != sizeof(Hash.Hash) * 2)
+	{
+		return Hash;
+	}
+	for(const TCHAR Char : InSha)
+	{
+		// uppercase shas are kept as is, so that every value reads back unchanged
+		if(!FChar::IsHexDigit(Char) || FChar::IsUpper(Char))
+		{
+			return Hash;
+		}
+	}
+	HexToBytes(InSha, Hash.Hash);
+	return Hash;
+}
+
+FString FGitSourceControlStateCache::FromShaHash(const FSHAHash& InHash)
+{
+	return InHash == FSHAHash() ? FString() : BytesToHexLower(InHash.Hash, sizeof(InHash.Hash));
+}
+
+void FGitSourceControlStateCache::AddChange(const FString& InFilename, EGitStateFields InFields)
+{
+	FScopeLock ScopeLock(&ChangesCriticalSection);
+	Changes.FindOrAdd(InFilename) |= InFields;
+}
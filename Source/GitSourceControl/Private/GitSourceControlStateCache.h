@@ -0,0 +1,322 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeRWLock.h"
+#include "Misc/SecureHash.h"
+#include "GitSourceControlState.h"
+#include "GitSourceControlPathTrie.h"
+
+#include <atomic>
+
+/** Fields of a cached state, to tell listeners which ones changed */
+enum class EGitStateFields : uint8
+{
+	None = 0,
+	/** Working copy state and pending resolve info */
+	WorkingCopy = 1 << 0,
+	/** Gitalong spread of the last commit */
+	Spread = 1 << 1,
+	/** Sha, branches, host and author of the last commit */
+	LastCommit = 1 << 2,
+	/** File history */
+	History = 1 << 3,
+	/** Time stamp of the spread served while offline */
+	SpreadTimeStamp = 1 << 4,
+	/** The file was removed from the cache */
+	Removed = 1 << 5,
+};
+ENUM_CLASS_FLAGS(EGitStateFields)
+
+/** Files whose state changed, with the fields that changed */
+typedef TMap<FString, EGitStateFields> FGitSourceControlStateDelta;
+
+/**
+ * Concurrent cache of file states, sharded by filename hash with a reader-writer lock per shard.
+ *
+ * Files are keyed by their normalized path relative to the repository, hashed once per lookup: absolute filenames of the repository
+ * that are already normalized (as the Editor provides them) are looked up without any allocation.
+ * States are not stored as FGitSourceControlState objects: each shard keeps the hot fields of its files in contiguous arrays indexed by a row,
+ * with commit shas as 20 bytes (other values in a side map), authors, hosts and branch lists as handles to the string table, and the rare history and resolve info in side maps.
+ * Files with local changes or claims are also kept in secondary indices, so that counting or listing them does not scan the whole cache,
+ * and counted in a trie of their folders for folder level queries.
+ * FGitSourceControlState objects are only materialized when asked for, and shared until the file changes.
+ * The states last materialized in each shard are pinned, so that the files the Editor keeps querying (eg. a Content Browser repainting)
+ * are found without building them again nor allocating, even though callers do not hold them.
+ *
+ * The presentation (icon and texts) of each row is computed once when its state changes and shared by every state materialized from it,
+ * for the Editor to paint them without string work.
+ *
+ * Materialized states are immutable snapshots: an update copies the state, modifies the copy and stores it in place of the previous one,
+ * so any state handed out can be read from any thread while workers publish new ones directly from their pool thread.
+ * Filenames of published states are recorded with the fields that changed, for the game thread to broadcast change notifications.
+ * All methods are thread safe.
+ */
+class FGitSourceControlStateCache
+{
+public:
+	typedef TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FStateRef;
+	typedef TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> FStatePtr;
+
+	/** Key files of a repository by their path relative to it (empties the cache if it changes; call while no other thread uses the cache) */
+	void SetRepositoryRoot(const FString& InRepositoryRoot);
+
+	/** Is a filename absolute, normalized and in the repository, so that it is looked up without allocation */
+	bool IsNormalized(FStringView InFilename) const;
+
+	/** Get the state of a file, caching an unknown state when missing */
+	FStateRef FindOrAdd(FStringView InFilename);
+
+	/** Get the state of a file, null when missing */
+	FStatePtr Find(FStringView InFilename) const;
+
+	/** Get the states of many files at once, null for files missing from the cache */
+	void Find(TConstArrayView<FString> InFilenames, TArray<FStatePtr>& OutStates) const;
+
+	/**
+	 * Publish a new state for a file: the function gets a copy of the current state (or an unknown state),
+	 * and returns true if it changed it, in which case the copy replaces the current state.
+	 * @returns the published state, null if unchanged
+	 */
+	FStatePtr Update(FStringView InFilename, TFunctionRef<bool(FGitSourceControlState&)> InUpdate);
+
+	/** Remove a file from the cache */
+	bool Remove(FStringView InFilename);
+
+	/** Remove all files */
+	void Empty();
+
+	/** Number of cached files */
+	int32 Num() const;
+
+	/** Memory that histories may use before the least recently used ones are evicted (0 for no limit) */
+	void SetHistoryBudget(int64 InBytes)
+	{
+		HistoryBudget = InBytes;
+	}
+
+	/** Memory used by the cached histories */
+	int64 GetHistoryBytes() const
+	{
+		return HistoryBytes;
+	}
+
+	/** Memory used by the cache and its path trie, materialized states and string table excluded */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Call a function on every cached state, shard by shard under a read lock (the function must not update the cache) */
+	void ForEach(TFunctionRef<void(const FStateRef&)> InFunction) const;
+
+	/** Number of cached files in an index (a single flag) */
+	int32 Num(EGitStateIndex InIndex) const;
+
+	/** Call a function on every cached state in any of the indices, once per file, under the same conditions as ForEach() */
+	void ForEach(EGitStateIndex InIndices, TFunctionRef<void(const FStateRef&)> InFunction) const;
+
+	/** Indices a state belongs to */
+	static EGitStateIndex GetIndices(const FGitSourceControlState& InState);
+
+	/** Folders of the cached files, with the aggregated states of the files below each of them */
+	const FGitSourceControlPathTrie& GetPathTrie() const
+	{
+		return PathTrie;
+	}
+
+	/** Take the files whose state changed since the last call, with the fields that changed; returns false if none */
+	bool ConsumeChanges(FGitSourceControlStateDelta& OutDelta);
+
+	/** Fields that differ between two states of the same file */
+	static EGitStateFields GetChangedFields(const FGitSourceControlState& InOldState, const FGitSourceControlState& InNewState);
+
+	/** Binary form of a commit sha, all zeros for an empty sha or anything else than a full lowercase SHA-1 (such as Gitalong's "0" for uncommitted changes) */
+	static FSHAHash ToShaHash(const FString& InSha);
+
+	/** Lowercase hexadecimal form of a commit sha, empty for all zeros */
+	static FString FromShaHash(const FSHAHash& InHash);
+
+private:
+	static constexpr int32 NumShards = 32;
+
+	/** States pinned per shard: a few thousands in all, more than the Editor shows at once */
+	static constexpr int32 NumPinnedPerShard = 256;
+	static constexpr int32 NumIndices = 7;
+
+	/** Case insensitive paths, also looked up by string view */
+	static uint32 GetPathHash(FStringView InPath)
+	{
+		return FCrc::Strihash_DEPRECATED(InPath.Len(), InPath.GetData());
+	}
+
+	struct FPathSetKeyFuncs : DefaultKeyFuncs<FString>
+	{
+		static bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::IgnoreCase);
+		}
+		static bool Matches(const FString& A, FStringView B)
+		{
+			return FStringView(A).Equals(B, ESearchCase::IgnoreCase);
+		}
+		static uint32 GetKeyHash(const FString& InKey)
+		{
+			return GetPathHash(InKey);
+		}
+	};
+
+	struct FPathMapKeyFuncs : TDefaultMapKeyFuncs<FString, int32, false>
+	{
+		static bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::IgnoreCase);
+		}
+		static bool Matches(const FString& A, FStringView B)
+		{
+			return FStringView(A).Equals(B, ESearchCase::IgnoreCase);
+		}
+		static uint32 GetKeyHash(const FString& InKey)
+		{
+			return GetPathHash(InKey);
+		}
+	};
+
+	/** Key of a file: its path relative to the repository (absolute outside of it), with its hash */
+	struct FKey
+	{
+		UE_NONCOPYABLE(FKey);
+		FKey() = default;
+
+		FStringView Path;
+		uint32 Hash = 0;
+
+		/** Only used when the filename had to be normalized */
+		FString Storage;
+	};
+
+	/** Make the key of a filename, only allocating if it is not normalized */
+	void MakeKey(FStringView InFilename, FKey& OutKey) const;
+
+	/** Absolute filename of a key */
+	FString ToFilename(FStringView InPath) const;
+
+	/** History of a file, with its size and when it was last used for the eviction of the least recently used ones */
+	struct FHistoryEntry
+	{
+		TGitSourceControlHistory History;
+		int64 Size = 0;
+		mutable int64 LastUse = 0;
+	};
+
+	/** Memory used by the revisions of a history */
+	static int64 GetHistorySize(const TGitSourceControlHistory& InHistory);
+
+	struct FShard
+	{
+		/** Row of each file in the arrays below, by key */
+		TMap<FString, int32, FDefaultSetAllocator, FPathMapKeyFuncs> Rows;
+
+		/** Rows of removed files, reused for new files */
+		TArray<int32> FreeRows;
+
+		/** Hot fields, one entry per row */
+		TArray<uint8> WorkingCopyStates;
+		TArray<ECommitSpread> Spreads;
+		TArray<FSHAHash> Shas;
+		TArray<FGitInternedString> Authors;
+		TArray<FGitInternedString> Hosts;
+		TArray<uint32> LocalBranchesIds;
+		TArray<uint32> RemoteBranchesIds;
+		TArray<int64> TimeStamps;
+		TArray<int64> SpreadTimeStamps;
+
+		/** Indices of each row, and files of each index (local changes and claims are a small part of a repository) */
+		TArray<EGitStateIndex> RowIndices;
+		TSet<FString, FPathSetKeyFuncs> Indices[NumIndices];
+
+		/** Presentation of each row, computed when its state changes */
+		TArray<FGitSourceControlState::FPresentationPtr> Presentations;
+
+		/** Cold fields, only for the few files that have one */
+		TMap<int32, FHistoryEntry> Histories;
+		TMap<int32, FResolveInfo> ResolveInfos;
+
+		/** Shas that are not a full SHA-1 (zero in Shas), kept as is */
+		TMap<int32, FString> OtherShas;
+
+		/** States materialized for callers, shared until their file changes */
+		mutable TMap<int32, TWeakPtr<FGitSourceControlState, ESPMode::ThreadSafe>> Materialized;
+		mutable int32 MaterializedPurgeThreshold = 64;
+
+		/** Ring of the states last materialized, keeping them alive until they are pushed out */
+		mutable TArray<FStatePtr> Pinned;
+		mutable int32 NextPinned = 0;
+		mutable FCriticalSection MaterializedCriticalSection;
+
+		mutable FRWLock Lock;
+	};
+
+	FShard& GetShard(const FKey& InKey)
+	{
+		return Shards[InKey.Hash % NumShards];
+	}
+
+	const FShard& GetShard(const FKey& InKey) const
+	{
+		return Shards[InKey.Hash % NumShards];
+	}
+
+	/** Find the state of a key, under the read lock of its shard */
+	FStatePtr FindInternal(const FKey& InKey) const;
+
+	/** Build a state from the fields of a row (shard lock held) */
+	FStateRef Build(const FShard& InShard, int32 InRow, FStringView InPath) const;
+
+	/** Get the shared state of a row, building it if no caller holds it anymore (shard lock held) */
+	FStateRef Materialize(const FShard& InShard, int32 InRow, FStringView InPath) const;
+
+	/** Keep a materialized state alive, pushing out the oldest pinned one (materialized lock held) */
+	static void Pin(const FShard& InShard, const FStateRef& InState);
+
+	/** Forget the materialized state of a row, pinned or not (shard write lock held) */
+	static void Forget(const FShard& InShard, int32 InRow);
+
+	/** Presentation of an unknown state, shared by all new rows */
+	static const FGitSourceControlState::FPresentationPtr& GetUnknownPresentation();
+
+	/** Add a row for a new file, with the fields of an unknown state (shard write lock held) */
+	int32 AddRow(FShard& InShard, const FKey& InKey, const FString& InFilename);
+
+	/** Store the fields of a state in a row (shard write lock held) */
+	void Store(FShard& InShard, int32 InRow, FStringView InPath, const FGitSourceControlState& InState);
+
+	/** Move a row to the indices of its state (shard write lock held) */
+	void Reindex(FShard& InShard, int32 InRow, FStringView InPath, uint32 InHash, EGitStateIndex InIndices);
+
+	/** Mark a history as just used (shard lock held) */
+	void Touch(const FHistoryEntry& InEntry) const;
+
+	/** Evict the least recently used histories until they use a fraction of the budget (no shard lock held) */
+	void TrimHistories();
+
+	/** Record changed fields of a file */
+	void AddChange(const FString& InFilename, EGitStateFields InFields);
+
+	/** Root of the repository, without trailing slash */
+	FString RepositoryRoot;
+
+	FShard Shards[NumShards];
+
+	/** Updated under the lock of the shard of each file (always taken before the lock of the trie) */
+	FGitSourceControlPathTrie PathTrie;
+
+	/** Eviction of the least recently used histories */
+	std::atomic<int64> HistoryBudget{0};
+	std::atomic<int64> HistoryBytes{0};
+	mutable std::atomic<int64> HistoryClock{0};
+	FCriticalSection TrimCriticalSection;
+
+	/** Files changed since the last ConsumeChanges() */
+	FGitSourceControlStateDelta Changes;
+	FCriticalSection ChangesCriticalSection;
+};
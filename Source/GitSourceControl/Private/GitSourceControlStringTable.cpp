@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GitSourceControlStringTable.h"
+#include "Algo/Compare.h"
+
+FGitInternedString::FGitInternedString(FStringView InString)
+	: Id(FGitSourceControlStringTable::Get().Intern(InString))
+{
+}
+
+FGitInternedString FGitInternedString::Find(FStringView InString)
+{
+	FGitInternedString Handle;
+	Handle.Id = FGitSourceControlStringTable::Get().Find(InString);
+	return Handle;
+}
+
+TArray<FGitInternedString> FGitInternedString::InternAll(const TArray<FString>& InStrings)
+{
+	TArray<FGitInternedString> Handles;
+	Handles.Reserve(InStrings.Num());
+	for(const FString& String : InStrings)
+	{
+		Handles.Emplace(String);
+	}
+	return Handles;
+}
+
+TArray<FString> FGitInternedString::ToStrings(const TArray<FGitInternedString>& InHandles)
+{
+	TArray<FString> Strings;
+	Strings.Reserve(InHandles.Num());
+	for(const FGitInternedString& Handle : InHandles)
+	{
+		Strings.Add(Handle.ToString());
+	}
+	return Strings;
+}
+
+const FString& FGitInternedString::ToString() const
+{
+	return FGitSourceControlStringTable::Get().Resolve(Id);
+}
+
+FGitSourceControlStringTable& FGitSourceControlStringTable::Get()
+{
+	static FGitSourceControlStringTable StringTable;
+	return StringTable;
+}
+
+FGitSourceControlStringTable::FGitSourceControlStringTable()
+{
+	// id 0 is the empty string, and the empty list
+	Strings.Add(MakeUnique<FString>());
+	Ids.Add(FString(), 0);
+	Lists.AddDefaulted();
+}
+
+uint32 FGitSourceControlStringTable::Intern(FStringView InString)
+{
+	if(InString.IsEmpty())
+	{
+		return 0;
+	}
+	const uint32 Hash = GetViewHash(InString);
+	{
+		FReadScopeLock ReadLock(Lock);
+		if(const uint32* Id = Ids.FindByHash(Hash, InString))
+		{
+			return *Id;
+		}
+	}
+	FWriteScopeLock WriteLock(Lock);
+	if(const uint32* Id = Ids.FindByHash(Hash, InString))
+	{
+		return *Id;
+	}
+	const uint32 Id = (uint32)Strings.Add(MakeUnique<FString>(InString));
+	Ids.AddByHash(Hash, *Strings[Id], Id);
+	return Id;
+}
+
+uint32 FGitSourceControlStringTable::Find(FStringView InString) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const uint32* Id = Ids.FindByHash(GetViewHash(InString), InString);
+	return Id ? *Id : 0;
+}
+
+const FString& FGitSourceControlStringTable::Resolve(uint32 InId) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return *Strings[InId];
+}
+
+uint32 FGitSourceControlStringTable::GetListHash(TConstArrayView<FGitInternedString> InList)
+{
+	uint32 Hash = 0;
+	for(const FGitInternedString& Handle : InList)
+	{
+		Hash = HashCombineFast(Hash, GetTypeHash(Handle));
+	}
+	return Hash;
+}
+
+uint32 FGitSourceControlStringTable::InternList(TConstArrayView<FGitInternedString> InList)
+{
+	if(InList.Num() == 0)
+	{
+		return 0;
+	}
+	auto FindList = [this, &InList](uint32 InHash) -> uint32
+	{
+		TArray<uint32, TInlineAllocator<4>> Candidates;
+		ListIdsByHash.MultiFind(InHash, Candidates);
+		for(const uint32 ListId : Candidates)
+		{
+			if(Algo::Compare(Lists[ListId], InList))
+			{
+				return ListId;
+			}
+		}
+		return 0;
+	};
+
+	const uint32 Hash = GetListHash(InList);
+	{
+		FReadScopeLock ReadLock(Lock);
+		if(const uint32 ListId = FindList(Hash))
+		{
+			return ListId;
+		}
+	}
+	FWriteScopeLock WriteLock(Lock);
+	if(const uint32 ListId = FindList(Hash))
+	{
+		return ListId;
+	}
+	const uint32 ListId = (uint32)Lists.Emplace(InList);
+	ListIdsByHash.Add(Hash, ListId);
+	return ListId;
+}
+
+TArray<FGitInternedString> FGitSourceControlStringTable::ResolveList(uint32 InListId) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Lists[InListId];
+}
+
+int32 FGitSourceControlStringTable::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Strings.Num();
+}
+
+SIZE_T FGitSourceControlStringTable::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+	SIZE_T Size = Strings.GetAllocatedSize() + Ids.GetAllocatedSize() + Lists.GetAllocatedSize() + ListIdsByHash.GetAllocatedSize();
+	for(const TUniquePtr<FString>& String : Strings)
+	{
+		// once in the array, once as a key of the map
+		Size += sizeof(FString) + 2 * String->GetAllocatedSize();
+	}
+	for(const TArray<FGitInternedString>& List : Lists)
+	{
+		Size += List.GetAllocatedSize();
+	}
+	return Size;
+}
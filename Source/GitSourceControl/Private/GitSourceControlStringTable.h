@@ -0,0 +1,130 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * Handle to a string stored once in FGitSourceControlStringTable, for values shared by many files (authors, hosts and branch names).
+ * Compared, hashed and copied as an integer; the default handle is the empty string.
+ */
+class FGitInternedString
+{
+public:
+	FGitInternedString() = default;
+
+	/** Intern a string (case sensitive) */
+	explicit FGitInternedString(FStringView InString);
+
+	/** Handle of a string if it was already interned, the empty string handle otherwise */
+	static FGitInternedString Find(FStringView InString);
+
+	/** Intern a list of strings */
+	static TArray<FGitInternedString> InternAll(const TArray<FString>& InStrings);
+
+	/** Resolve a list of handles */
+	static TArray<FString> ToStrings(const TArray<FGitInternedString>& InHandles);
+
+	/** The interned string, valid for the lifetime of the module */
+	const FString& ToString() const;
+
+	bool IsEmpty() const
+	{
+		return Id == 0;
+	}
+
+	uint32 GetId() const
+	{
+		return Id;
+	}
+
+	bool operator==(const FGitInternedString& Other) const
+	{
+		return Id == Other.Id;
+	}
+
+	bool operator!=(const FGitInternedString& Other) const
+	{
+		return Id != Other.Id;
+	}
+
+	friend uint32 GetTypeHash(const FGitInternedString& InHandle)
+	{
+		return InHandle.Id;
+	}
+
+private:
+	friend class FGitSourceControlStringTable;
+
+	uint32 Id = 0;
+};
+
+/**
+ * Process wide table of interned strings and lists of interned strings.
+ * Strings are never removed: they are a few hundred distinct values for hundreds of thousands of files.
+ * All methods are thread safe.
+ */
+class FGitSourceControlStringTable
+{
+public:
+	static FGitSourceControlStringTable& Get();
+
+	/** Id of a string, adding it to the table if needed (0 for the empty string) */
+	uint32 Intern(FStringView InString);
+
+	/** Id of a string already in the table, 0 if missing */
+	uint32 Find(FStringView InString) const;
+
+	/** String of an id */
+	const FString& Resolve(uint32 InId) const;
+
+	/** Id of a list of handles, adding it to the table if needed (0 for the empty list) */
+	uint32 InternList(TConstArrayView<FGitInternedString> InList);
+
+	/** List of handles of an id */
+	TArray<FGitInternedString> ResolveList(uint32 InListId) const;
+
+	/** Number of distinct strings */
+	int32 Num() const;
+
+	/** Memory used by the table */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	FGitSourceControlStringTable();
+
+	/** Case sensitive lookups, also by string view */
+	struct FKeyFuncs : TDefaultMapKeyFuncs<FString, uint32, false>
+	{
+		static bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+		static bool Matches(const FString& A, FStringView B)
+		{
+			return FStringView(A).Equals(B, ESearchCase::CaseSensitive);
+		}
+		static uint32 GetKeyHash(const FString& InKey)
+		{
+			return GetViewHash(InKey);
+		}
+	};
+
+	static uint32 GetViewHash(FStringView InString)
+	{
+		return FCrc::MemCrc32(InString.GetData(), InString.Len() * sizeof(TCHAR));
+	}
+
+	static uint32 GetListHash(TConstArrayView<FGitInternedString> InList);
+
+	/** Strings are allocated one by one so that references to them stay valid when the array grows */
+	TArray<TUniquePtr<FString>> Strings;
+	TMap<FString, uint32, FDefaultSetAllocator, FKeyFuncs> Ids;
+
+	TArray<TArray<FGitInternedString>> Lists;
+	TMultiMap<uint32, uint32> ListIdsByHash;
+
+	mutable FRWLock Lock;
+};
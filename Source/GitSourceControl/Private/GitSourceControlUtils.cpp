@@ -11,12 +11,18 @@ using namespace std::chrono;
 #include "GitSourceControlProvider.h"
 #include "GitSourceControlCommand.h"
 #include "GitSourceControlState.h"
+#include "GitSourceControlOutput.h"
 #include "HAL/PlatformProcess.h"
 #include "HAL/PlatformFile.h"
 #include "HAL/PlatformFileManager.h"
 #include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Misc/MemStack.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Styling/AppStyle.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "String/Find.h"
 #include "Modules/ModuleManager.h"
 #include "ISourceControlModule.h"
 #include "GitSourceControlModule.h"
@@ -31,6 +37,9 @@ namespace GitSourceControlConstants
 	/** The maximum number of files we submit in a single Git command */
 	const int32 MaxFilesPerBatch = 50;
 	const int32 MaxFilesPerClaimBatch = 1;
+
+	/** Delay after which the whole repository claims are queried again when spread is computed locally */
+	const double ClaimsRefreshInterval = 30.0;
 }
 
 FGitScopedTempFile::FGitScopedTempFile(const FText& InText)
@@ -62,10 +71,9 @@ const FString& FGitScopedTempFile::GetFilename() const
 namespace GitSourceControlUtils
 {
 
-// Launch the Git command line process and extract its results & errors
-static bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors, const FString& InPathToGitalongBinary = FString())
+// Build the command line of a Git or Gitalong command
+static FString MakeCommandLine(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles)
 {
-	int32 ReturnCode = 0;
 	FString FullCommand;
 	FString LoggableCommand; // short version of the command for logging purpose
 	if(!InRepositoryRoot.IsEmpty())
@@ -110,7 +118,7 @@ static bool RunCommandInternalRaw(const FString& InCommand, const FString& InPat
 
 	FullCommand += LoggableCommand;
 	
-	UE_LOG(LogSourceControl, Log, TEXT("RunCommandInternalRaw: '%s %s'"), *InPathToBinary, *LoggableCommand);
+	UE_LOG(LogSourceControl, Log, TEXT("RunCommand: '%s %s'"), *InPathToBinary, *LoggableCommand);
 	
 #if PLATFORM_MAC
 	// The Cocoa application does not inherit shell environment variables, so add the path expected to have git-lfs to PATH
@@ -135,8 +143,21 @@ static bool RunCommandInternalRaw(const FString& InCommand, const FString& InPat
 		FullCommand = FString::Printf(TEXT("PATH=\"%s%s%s\" \"%s\" %s"), *InstallPath, FPlatformMisc::GetPathVarDelimiter(), *PathEnv, *InPathToBinary, *FullCommand);
 	}
 #endif
+	return FullCommand;
+}
+
+// Launch the Git command line process and extract its results & errors
+static bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors, const FString& InPathToGitalongBinary = FString())
+{
+	int32 ReturnCode = 0;
+	const FString FullCommand = MakeCommandLine(InCommand, InPathToBinary, InRepositoryRoot, InParameters, InFiles);
 	auto start = high_resolution_clock::now();
-	FPlatformProcess::ExecProcess(*InPathToBinary, *FullCommand, &ReturnCode, &OutResults, &OutErrors);
+	if(!FPlatformProcess::ExecProcess(*InPathToBinary, *FullCommand, &ReturnCode, &OutResults, &OutErrors))
+	{
+		// same message as RunCommandInternalOutput(), that callers can tell from errors of the command itself
+		ReturnCode = -1;
+		OutErrors += FString::Printf(TEXT("Failed to launch '%s'"), *InPathToBinary);
+	}
 	auto stop = high_resolution_clock::now();
 	auto duration = duration_cast<milliseconds>(stop - start);
 #if UE_BUILD_DEBUG
@@ -171,6 +192,66 @@ static bool RunCommandInternalRaw(const FString& InCommand, const FString& InPat
 	return ReturnCode == 0;
 }
 
+// Launch the command line process and keep the raw bytes of its results, reading both pipes while it runs so that it never blocks on a full one
+static bool RunCommandInternalOutput(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, EGitRecordSeparator InSeparator, FGitOutput& OutResults, TArray<FString>& OutErrorMessages)
+{
+	int32 ReturnCode = -1;
+	const FString FullCommand = MakeCommandLine(InCommand, InPathToBinary, InRepositoryRoot, InParameters, InFiles);
+	auto start = high_resolution_clock::now();
+
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdErrRead = nullptr;
+	void* StdErrWrite = nullptr;
+	verify(FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite));
+	verify(FPlatformProcess::CreatePipe(StdErrRead, StdErrWrite));
+
+	FString Errors;
+	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*InPathToBinary, *FullCommand, false, true, true, nullptr, 0, nullptr, StdOutWrite, nullptr, StdErrWrite);
+	if(ProcessHandle.IsValid())
+	{
+		TArray<uint8> BinaryData;
+		bool bRunning = true;
+		bool bRead = true;
+		// after the process exits, drain what is left in the pipes
+		while(bRunning || bRead)
+		{
+			bRunning = FPlatformProcess::IsProcRunning(ProcessHandle);
+			FPlatformProcess::ReadPipeToArray(StdOutRead, BinaryData);
+			OutResults.Append(BinaryData);
+			const FString ErrorData = FPlatformProcess::ReadPipe(StdErrRead);
+			Errors += ErrorData;
+			bRead = BinaryData.Num() > 0 || !ErrorData.IsEmpty();
+			if(bRunning && !bRead)
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+		}
+		FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
+		FPlatformProcess::CloseProc(ProcessHandle);
+	}
+	else
+	{
+		Errors = FString::Printf(TEXT("Failed to launch '%s'"), *InPathToBinary);
+	}
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+	OutResults.Split(InSeparator);
+
+	auto stop = high_resolution_clock::now();
+	auto duration = duration_cast<milliseconds>(stop - start);
+	if(!Errors.IsEmpty())
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("RunCommandInternalOutput(%s): %s"), *InCommand, *Errors);
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("RunCommandInternalOutput(%s): Duration=%lld ms Records=%d"), *InCommand, duration.count(), OutResults.Num());
+
+	TArray<FString> ErrorMessages;
+	Errors.ParseIntoArray(ErrorMessages, TEXT("\n"), true);
+	OutErrorMessages.Append(MoveTemp(ErrorMessages));
+	return ReturnCode == 0;
+}
+
 // Basic parsing or results & errors from the Git command line process
 static bool RunCommandInternal(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
 {
@@ -467,6 +548,29 @@ bool RunCommand(const FString& InCommand, const FString& InPathToBinary, const F
 	return bResult;
 }
 
+bool RunCommandOutput(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, EGitRecordSeparator InSeparator, FGitOutput& OutResults, TArray<FString>& OutErrorMessages)
+{
+	OutResults.Reset();
+	if(InFiles.Num() <= GitSourceControlConstants::MaxFilesPerBatch)
+	{
+		return RunCommandInternalOutput(InCommand, InPathToBinary, InRepositoryRoot, InParameters, InFiles, InSeparator, OutResults, OutErrorMessages);
+	}
+
+	// Batch files up so we dont exceed command-line limits, all the results in the same output
+	bool bResult = true;
+	int32 FileCount = 0;
+	while(FileCount < InFiles.Num())
+	{
+		TArray<FString> FilesInBatch;
+		for(int32 FileIndex = 0; FileCount < InFiles.Num() && FileIndex < GitSourceControlConstants::MaxFilesPerBatch; FileIndex++, FileCount++)
+		{
+			FilesInBatch.Add(InFiles[FileCount]);
+		}
+		bResult &= RunCommandInternalOutput(InCommand, InPathToBinary, InRepositoryRoot, InParameters, FilesInBatch, InSeparator, OutResults, OutErrorMessages);
+	}
+	return bResult;
+}
+
 // Run a Git "commit" command by batches
 bool RunCommit(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
 {
@@ -576,10 +680,11 @@ R  Content/Textures/T_Perlin_Noise_M.uasset -> Content/Textures/T_Perlin_Noise_M
  *
  * @see FGitStatusFileMatcher and StateFromGitStatus()
  */
-static FString FilenameFromGitStatus(const FString& InResult)
+template<typename CharType>
+static TStringView<CharType> FilenameFromGitStatus(TStringView<CharType> InResult)
 {
 	int32 RenameIndex;
-	if(InResult.FindLastChar('>', RenameIndex))
+	if(InResult.FindLastChar(CharType('>'), RenameIndex))
 	{
 		// Extract only the second part of a rename "from -> to"
 		return InResult.RightChop(RenameIndex + 2);
@@ -604,33 +709,36 @@ static FString FilenameFromGitStatus(const FString& InResult)
  *
  * @see FGitStatusFileMatcher and StateFromGitStatus()
  */
-static FString FilenameFromGitalongStatus(const FString& InResult)
+template<typename CharType>
+static TStringView<CharType> FilenameFromGitalongStatus(TStringView<CharType> InResult)
 {
-	TArray<FString> Splits;
-	InResult.ParseIntoArray(Splits, TEXT(" "));
-	if (Splits.Num() > 1)
+	// the second field, without splitting the whole line
+	TStringView<CharType> Line = InResult.TrimStart();
+	int32 SpaceIndex;
+	if(!Line.FindChar(CharType(' '), SpaceIndex))
 	{
-		return Splits[1];
+		return TStringView<CharType>();
 	}
-	return FString("");
+	Line = Line.RightChop(SpaceIndex + 1).TrimStart();
+	return Line.FindChar(CharType(' '), SpaceIndex) ? Line.Left(SpaceIndex) : Line.TrimEnd();
 }
 
-/** Match the relative filename of a Git status result with a provided absolute filename */
+/** Match the relative filename of a Git status result with a provided absolute filename, compared as UTF-8 like the results */
 class FGitStatusFileMatcher
 {
 public:
-	FGitStatusFileMatcher(const FString& InAbsoluteFilename)
+	FGitStatusFileMatcher(FUtf8StringView InAbsoluteFilename)
 		: AbsoluteFilename(InAbsoluteFilename)
 	{
 	}
 
-	bool operator()(const FString& InResult) const
+	bool operator()(FUtf8StringView InResult) const
 	{
-		return AbsoluteFilename.Contains(FilenameFromGitStatus(InResult));
+		return UE::String::FindFirst(AbsoluteFilename, FilenameFromGitStatus(InResult), ESearchCase::IgnoreCase) != INDEX_NONE;
 	}
 
 private:
-	const FString& AbsoluteFilename;
+	FUtf8StringView AbsoluteFilename;
 };
 
 /** Match the relative filename of a Gitalong status result with a provided absolute filename */
@@ -644,13 +752,19 @@ public:
 
 	bool operator()(const FString& InResult) const
 	{
-		return AbsoluteFilename.Contains(FilenameFromGitalongStatus(InResult));
+		return UE::String::FindFirst(AbsoluteFilename, FilenameFromGitalongStatus(FStringView(InResult)), ESearchCase::IgnoreCase) != INDEX_NONE;
 	}
 
 private:
 	const FString& AbsoluteFilename;
 };
 
+FParseAllocationCounts& GetParseAllocationCounts()
+{
+	static thread_local FParseAllocationCounts Counts;
+	return Counts;
+}
+
 /**
  * Extract and interpret the file state from the given Git status result.
  * @see http://git-scm.com/docs/git-status
@@ -667,10 +781,12 @@ private:
 class FGitStatusParser
 {
 public:
-	FGitStatusParser(const FString& InResult)
+	template<typename CharType>
+	FGitStatusParser(TStringView<CharType> InResult)
 	{
-		const TCHAR IndexState = InResult[0];
-		const TCHAR WCopyState = InResult[1];
+		GetParseAllocationCounts().Lines++;
+		const TCHAR IndexState = (TCHAR)InResult[0];
+		const TCHAR WCopyState = (TCHAR)InResult[1];
 		if(   (IndexState == 'U' || WCopyState == 'U')
 		   || (IndexState == 'A' && WCopyState == 'A')
 		   || (IndexState == 'D' && WCopyState == 'D'))
@@ -728,99 +844,138 @@ public:
 --+ Content/Textures/T_Perlin_Noise_M.uasset 0 feature-a epic1 Tim Sweeney
 === Content/Materials/M_Basic_Wall.uasset
 */
+/** Intern a field of a result */
+static FGitInternedString Intern(FStringView InField)
+{
+	return FGitInternedString(InField);
+}
+
+static FGitInternedString Intern(FUtf8StringView InField)
+{
+	// converted on the stack: most authors, hosts and branches are already interned
+	const auto Converted = StringCast<TCHAR>(InField.GetData(), InField.Len());
+	return FGitInternedString(FStringView(Converted.Get(), Converted.Length()));
+}
+
+/** Intern a comma separated list of branch names, without allocating a string per branch */
+template<typename CharType>
+static void ParseBranches(TStringView<CharType> InBranches, TArray<FGitInternedString>& OutBranches)
+{
+	while(!InBranches.IsEmpty())
+	{
+		int32 CommaIndex = INDEX_NONE;
+		const TStringView<CharType> Branch = InBranches.FindChar(CharType(','), CommaIndex) ? InBranches.Left(CommaIndex) : InBranches;
+		if(!Branch.IsEmpty())
+		{
+			OutBranches.Add(Intern(Branch));
+		}
+		InBranches.RightChopInline(Branch.Len() + 1);
+	}
+}
+
+/** Split a line into views of its fields separated by spaces, without copying them */
+template<typename CharType, typename AllocatorType>
+static void SplitFields(TStringView<CharType> InLine, TArray<TStringView<CharType>, AllocatorType>& OutFields)
+{
+	while(!InLine.IsEmpty())
+	{
+		int32 SpaceIndex = INDEX_NONE;
+		const TStringView<CharType> Field = InLine.FindChar(CharType(' '), SpaceIndex) ? InLine.Left(SpaceIndex) : InLine;
+		if(!Field.IsEmpty())
+		{
+			OutFields.Add(Field);
+		}
+		InLine.RightChopInline(Field.Len() + 1);
+	}
+}
+
 class FGitalongStatusParser
 {
 public:
-	FGitalongStatusParser(const FString& InResult)
+	template<typename CharType>
+	FGitalongStatusParser(TStringView<CharType> InResult)
 	{
-		TArray<FString> Splits;
+		// the fields only live while parsing: taken from the memory stack of the thread, released at once
+		FMemMark Mark(FMemStack::Get());
+		const int32 StackBytesBefore = FMemStack::Get().GetByteCount();
+		TArray<TStringView<CharType>, TMemStackAllocator<>> Fields;
 		// @todo This space split parsing won't support filenames with spaces.
-		InResult.ParseIntoArray(Splits, TEXT(" "));
+		SplitFields(InResult, Fields);
+		FParseAllocationCounts& Counts = GetParseAllocationCounts();
+		Counts.Lines++;
+		Counts.StackBytes += FMemStack::Get().GetByteCount() - StackBytesBefore;
 		LastCommitSpread = ECommitSpread::Unknown;
-		if (Splits.Num() > 0)
-		{
-			if (Splits[0][0] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::LocalUncommitted;
-			}
-			if (Splits[0][1] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::LocalActiveBranch;
-			}
-			if (Splits[0][2] == '+')
+		if (Fields.Num() > 0)
+		{
+			static constexpr ECommitSpread SpreadFlags[] = {
+				ECommitSpread::LocalUncommitted, ECommitSpread::LocalActiveBranch, ECommitSpread::LocalOtherBranch, ECommitSpread::RemoteMatchingBranch,
+				ECommitSpread::RemoteOtherBranch, ECommitSpread::CloneOtherBranch, ECommitSpread::CloneMatchingBranch, ECommitSpread::CloneUncommitted
+			};
+			const TStringView<CharType> Status = Fields[0];
+			for (int32 Index = 0; Index < UE_ARRAY_COUNT(SpreadFlags) && Index < Status.Len(); Index++)
 			{
-				LastCommitSpread |= ECommitSpread::LocalOtherBranch;
+				if (Status[Index] == CharType('+'))
+				{
+					LastCommitSpread |= SpreadFlags[Index];
+				}
 			}
-			if (Splits[0][3] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::RemoteMatchingBranch;
-			}
-			if (Splits[0][4] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::RemoteOtherBranch;
-			}
-			if (Splits[0][5] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::CloneOtherBranch;
-			}
-			if (Splits[0][6] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::CloneMatchingBranch;
-			}
-			if (Splits[0][7] == '+')
-			{
-				LastCommitSpread |= ECommitSpread::CloneUncommitted;
-			}
-			Splits.RemoveAt(0);
-		}
-		if (Splits.Num() > 0)
-		{
-			// Removing the filename which is the second item in the splits and that we already know.
-			Splits.RemoveAt(0);
-		}
-		if (Splits.Num() > 0)
-		{
-			LastCommitSha = Splits[0] == "-" ? "" : Splits[0];
-			Splits.RemoveAt(0);
 		}
-		if (Splits.Num() > 0)
+		// The filename is the second field, that we already know.
+		if (Fields.Num() > 2)
 		{
-			if (Splits[0] != "-")
+			if(!IsNone(Fields[2]))
 			{
-				Splits[0].ParseIntoArray(LastCommitLocalBranches, TEXT(","));
+				LastCommitSha = GitSourceControlOutput::ToString(Fields[2]);
+				Counts.HeapCopies++;
 			}
-			Splits.RemoveAt(0);
 		}
-		if (Splits.Num() > 0)
+		if (Fields.Num() > 3 && !IsNone(Fields[3]))
 		{
-			if (Splits[0] != "-")
-			{
-				Splits[0].ParseIntoArray(LastCommitRemoteBranches, TEXT(","));;
-			}
-			Splits.RemoveAt(0);
+			ParseBranches(Fields[3], LastCommitLocalBranches);
+		}
+		if (Fields.Num() > 4 && !IsNone(Fields[4]))
+		{
+			ParseBranches(Fields[4], LastCommitRemoteBranches);
 		}
-		if (Splits.Num() > 0)
+		if (Fields.Num() > 5 && !IsNone(Fields[5]))
 		{
-			LastCommitHost = Splits[0] == "-" ? "" : Splits[0];
-			Splits.RemoveAt(0);
+			LastCommitHost = Intern(Fields[5]);
 		}
-		if (Splits.Num() > 0)
+		if (Fields.Num() > 6)
 		{
-			// The remainder of the splits are the author.
-			FString Author = FString::Join(Splits, TEXT(" "));
-			Author.RemoveFromEnd("\n");
-			LastCommitAuthor = (Author);
+			// The remainder of the line is the author.
+			const TStringView<CharType> Author(Fields[6].GetData(), UE_PTRDIFF_TO_INT32(InResult.GetData() + InResult.Len() - Fields[6].GetData()));
+			LastCommitAuthor = Intern(Author.TrimEnd());
 		}
 	}
+
+	/** Gitalong writes "-" for missing fields */
+	template<typename CharType>
+	static bool IsNone(TStringView<CharType> InField)
+	{
+		return InField.Len() == 1 && InField[0] == CharType('-');
+	}
+
 	ECommitSpread LastCommitSpread;
 	FString LastCommitSha;
-	TArray<FString> LastCommitLocalBranches;
-	TArray<FString> LastCommitRemoteBranches;
-	FString LastCommitHost;
-	FString LastCommitAuthor;
+	TArray<FGitInternedString> LastCommitLocalBranches;
+	TArray<FGitInternedString> LastCommitRemoteBranches;
+	FGitInternedString LastCommitHost;
+	FGitInternedString LastCommitAuthor;
 
 };
 
+/** Copy the Gitalong part of a status into a file state */
+static void ApplyGitalongStatus(const FGitalongStatusParser& InStatusParser, FGitSourceControlState& OutFileState)
+{
+	OutFileState.LastCommitSpread = InStatusParser.LastCommitSpread;
+	OutFileState.LastCommitSha = InStatusParser.LastCommitSha;
+	OutFileState.LastCommitLocalBranches = InStatusParser.LastCommitLocalBranches;
+	OutFileState.LastCommitRemoteBranches = InStatusParser.LastCommitRemoteBranches;
+	OutFileState.LastCommitHost = InStatusParser.LastCommitHost;
+	OutFileState.LastCommitAuthor = InStatusParser.LastCommitAuthor;
+}
+
 /**
  * Extract the status of a unmerged (conflict) file
  *
@@ -950,7 +1105,7 @@ R  Content/Textures/T_Perlin_Noise_M.uasset -> Content/Textures/T_Perlin_Noise_M
 ?? Content/Materials/M_Basic_Wall.uasset
 !! BasicCode.sln
 */
-static void ParseFileStatusResult(const FString& InPathToGitBinary, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, const TArray<FString>& InResults, const TArray<FString>& InGitalongResults, TArray<FGitSourceControlState>& OutStates)
+static void ParseFileStatusResult(const FString& InPathToGitBinary, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, const FGitOutput& InResults, const TArray<FString>& InGitalongResults, TArray<FGitSourceControlState>& OutStates)
 {
 	const FDateTime Now = FDateTime::Now();
 
@@ -962,17 +1117,13 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 		const int32 IdxGitalongResult = InGitalongResults.IndexOfByPredicate(FGitalongStatusFileMatcher(File));
 		if(IdxGitalongResult != INDEX_NONE)
 		{
-			const FGitalongStatusParser StatusParser(InGitalongResults[IdxGitalongResult]);
-			FileState.LastCommitSpread = StatusParser.LastCommitSpread;
-			FileState.LastCommitSha = StatusParser.LastCommitSha;
-			FileState.LastCommitLocalBranches = StatusParser.LastCommitLocalBranches;
-			FileState.LastCommitRemoteBranches = StatusParser.LastCommitRemoteBranches;
-			FileState.LastCommitHost = StatusParser.LastCommitHost;
-			FileState.LastCommitAuthor = StatusParser.LastCommitAuthor;
+			const FGitalongStatusParser StatusParser(FStringView(InGitalongResults[IdxGitalongResult]));
+			ApplyGitalongStatus(StatusParser, FileState);
 		}
 
-		// Search the file in the list of status
-		const int32 IdxResult = InResults.IndexOfByPredicate(FGitStatusFileMatcher(File));
+		// Search the file in the list of status, in the encoding of the results
+		const auto Utf8File = StringCast<UTF8CHAR>(*File, File.Len());
+		const int32 IdxResult = InResults.IndexOfByPredicate(FGitStatusFileMatcher(FUtf8StringView(Utf8File.Get(), Utf8File.Length())));
 		if(IdxResult != INDEX_NONE)
 		{
 			// File found in status results; only the case for "changed" files
@@ -1010,13 +1161,13 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
  *
  * @see #ParseFileStatusResult() above for an example of a 'git status' results
 */
-static void ParseDirectoryStatusResult(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InResults, TArray<FGitSourceControlState>& OutStates)
+static void ParseDirectoryStatusResult(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FGitOutput& InResults, TArray<FGitSourceControlState>& OutStates)
 {
 	// Iterate on each line of result of the status command
-	for(const FString& Result : InResults)
+	for(int32 IdxResult = 0; IdxResult < InResults.Num(); IdxResult++)
 	{
-		const FString RelativeFilename = FilenameFromGitStatus(Result);
-		const FString File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename);
+		const FUtf8StringView Result = InResults[IdxResult];
+		const FString File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, GitSourceControlOutput::ToString(FilenameFromGitStatus(Result)));
 
 		FGitSourceControlState FileState(File);
 		FGitStatusParser StatusParser(Result);
@@ -1043,7 +1194,7 @@ static void ParseDirectoryStatusResult(const FString& InPathToGitBinary, const F
  * @param[out]	InGitalongResults		Results from the gitalong command
  * @param[out]	OutStates				States of files for witch the status has been gathered (distinct than InFiles in case of a "directory status")
  */
-static void ParseStatusResults(const FString& InPathToGitBinary, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, const TArray<FString>& InResults, const TArray<FString>& InGitalongResults, TArray<FGitSourceControlState>& OutStates)
+static void ParseStatusResults(const FString& InPathToGitBinary, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, const FGitOutput& InResults, const TArray<FString>& InGitalongResults, TArray<FGitSourceControlState>& OutStates)
 {
 	if(1 == InFiles.Num() && FPaths::DirectoryExists(InFiles[0]))
 	{
@@ -1057,17 +1208,97 @@ static void ParseStatusResults(const FString& InPathToGitBinary, const FString&
 	}
 }
 
+// Run a Gitalong "claim" or "update" command, or commit it to the claim journal to be replayed in the background when enabled.
+bool RunGitalongCommand(const FString& InCommand, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlClaimJournal& ClaimJournal = GitSourceControl.GetProvider().GetClaimJournal();
+	if(ClaimJournal.IsRunning())
+	{
+		ClaimJournal.Append(InCommand, InFiles);
+		return true;
+	}
+	if(InCommand == TEXT("claim"))
+	{
+		return RunClaim(InPathToGitalongBinary, InRepositoryRoot, TArray<FString>(), InFiles, OutResults, OutErrorMessages);
+	}
+	return RunCommand(InCommand, InPathToGitalongBinary, InRepositoryRoot, TArray<FString>(), InFiles, OutResults, OutErrorMessages);
+}
+
+// Run a Gitalong "status" command, or serve the last known status of the files from the claim journal when Gitalong is unreachable
+static void RunGitalongStatus(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutGitalongResults)
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlClaimJournal& ClaimJournal = GitSourceControl.GetProvider().GetClaimJournal();
+	TArray<FString> GitalongErrorMessages;
+	if(!ClaimJournal.IsRunning())
+	{
+		RunCommand(TEXT("status"), InPathToGitalongBinary, InRepositoryRoot, TArray<FString>(), InFiles, OutGitalongResults, GitalongErrorMessages);
+		return;
+	}
+
+	if(ClaimJournal.IsOnline())
+	{
+		TArray<FString> GitalongResults;
+		if(RunCommand(TEXT("status"), InPathToGitalongBinary, InRepositoryRoot, TArray<FString>(), InFiles, GitalongResults, GitalongErrorMessages))
+		{
+			ClaimJournal.RecordStatus(GitalongResults);
+			OutGitalongResults.Append(MoveTemp(GitalongResults));
+			return;
+		}
+		ClaimJournal.ReportUnreachable(InFiles);
+	}
+
+	const FString RootPrefix = InRepositoryRoot / TEXT("");
+	for(const FString& File : InFiles)
+	{
+		FString RelativeFilename = File;
+		FPaths::MakePathRelativeTo(RelativeFilename, *RootPrefix);
+		ClaimJournal.GetLastKnownStatuses(RelativeFilename, OutGitalongResults);
+	}
+}
+
 // Run a batch of Git "status" command to update status of given files and/or directories.
 bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutErrorMessages, TArray<FGitSourceControlState>& OutStates)
 {
 	bool bResults = true;
-	TArray<FString> Results;
+	FGitOutput Results;
 	TArray<FString> Parameters;
 	Parameters.Add(TEXT("--porcelain"));
 	Parameters.Add(TEXT("--ignored"));
 
 	TArray<FString> GitalongResults;
-	TArray<FString> GitalongParameters;
+
+	// When spread is computed locally from refs, Gitalong is only needed for the Clone* bits, which come from the whole repository claims
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
+	FGitSourceControlClaimStore& ClaimStore = Provider.GetClaimStore();
+	bool bUseLocalSpread = GitSourceControl.AccessSettings().IsLocalSpreadEngineEnabled() || ClaimStore.IsConfigured();
+	if(bUseLocalSpread)
+	{
+		bUseLocalSpread = Provider.GetSpreadEngine().Refresh(InPathToGitBinary, InRepositoryRoot, OutErrorMessages);
+		if(bUseLocalSpread && ClaimStore.IsConfigured())
+		{
+			// One conditional request to the store, only rebuilding the index when the snapshot changed
+			// (no request at all while the relay pushes changes)
+			if(!Provider.GetClaimSubscription().IsConnected() && ClaimStore.Refresh(OutErrorMessages))
+			{
+				TArray<FGitSourceControlState> Claims;
+				ClaimStore.GetClaims(InRepositoryRoot, Provider.GetBranchName(), Claims);
+				Provider.GetClaimIndex().Rebuild(Claims);
+			}
+		}
+		else if(bUseLocalSpread && (FPlatformTime::Seconds() - Provider.GetClaimIndex().GetLastRebuildTime()) > GitSourceControlConstants::ClaimsRefreshInterval)
+		{
+			TArray<FString> GitalongErrorMessages;
+			TArray<FGitSourceControlState> Claims;
+			if(RunGetClaims(InPathToGitalongBinary, InRepositoryRoot, GitalongErrorMessages, Claims))
+			{
+				Provider.GetClaimIndex().Rebuild(Claims);
+			}
+		}
+	}
+	const int32 FirstStateIndex = OutStates.Num();
 	
 	// Git status does not show any "untracked files" when called with files from different subdirectories! (issue #3)
 	// 1) So here we group files by path (ie. by subdirectory)
@@ -1111,10 +1342,35 @@ bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InPathToGi
 			//   (this is triggered by the "Submit to Revision Control" menu)
 			TArray<FString> DirectoryFiles;
 			const FString& Directory = OnePath[0];
+			FGitFolderStatus FolderStatus;
+			if(bUseLocalSpread && Provider.GetStateCache().GetPathTrie().GetFolderStatus(Directory, FolderStatus))
+			{
+				// The folder is already cached, and the spread engine gets claims from the claim index: only files reported by "git status"
+				// and files of the folder with local changes or claims may have changed, no need to list and query all the others again
+				FGitOutput StatusResults;
+				if(RunCommandOutput(TEXT("status"), InPathToGitBinary, InRepositoryRoot, Parameters, OnePath, EGitRecordSeparator::NewLine, StatusResults, ErrorMessages))
+				{
+					Provider.GetStateCache().GetPathTrie().GetFiles(Directory, EGitStateIndex::Modified | EGitStateIndex::CheckedOut | EGitStateIndex::CheckedOutOther | EGitStateIndex::NotCurrent, false, DirectoryFiles);
+					for(int32 IdxResult = 0; IdxResult < StatusResults.Num(); IdxResult++)
+					{
+						const FString File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, GitSourceControlOutput::ToString(FilenameFromGitStatus(StatusResults[IdxResult])));
+						if(FPaths::GetPath(File).Equals(Directory, ESearchCase::IgnoreCase))
+						{
+							DirectoryFiles.AddUnique(File);
+						}
+					}
+					ParseStatusResults(InPathToGitBinary, InPathToGitalongBinary, InRepositoryRoot, DirectoryFiles, StatusResults, GitalongResults, OutStates);
+					continue;
+				}
+				OutErrorMessages.Append(ErrorMessages);
+				ErrorMessages.Reset();
+			}
 			if(const bool bResult = ListFilesInDirectory(InPathToGitBinary, InRepositoryRoot, Directory, DirectoryFiles))
 			{
-				TArray<FString> GitalongErrorMessages;
-				RunCommand(TEXT("status"), InPathToGitalongBinary, InRepositoryRoot, GitalongParameters, DirectoryFiles, GitalongResults, GitalongErrorMessages);
+				if(!bUseLocalSpread)
+				{
+					RunGitalongStatus(InPathToGitalongBinary, InRepositoryRoot, DirectoryFiles, GitalongResults);
+				}
 				ParseStatusResults(InPathToGitBinary, InPathToGitalongBinary, InRepositoryRoot, DirectoryFiles, Results, GitalongResults, OutStates);
 				continue;
 			}
@@ -1124,19 +1380,133 @@ bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InPathToGi
 			continue;
 		}
 		
-		const bool bResult = RunCommand(TEXT("status"), InPathToGitBinary, InRepositoryRoot, Parameters, OnePath, Results, ErrorMessages);
+		const bool bResult = RunCommandOutput(TEXT("status"), InPathToGitBinary, InRepositoryRoot, Parameters, OnePath, EGitRecordSeparator::NewLine, Results, ErrorMessages);
 		OutErrorMessages.Append(ErrorMessages);
 		if(bResult)
 		{
-			TArray<FString> GitalongErrorMessages;
-			RunCommand(TEXT("status"), InPathToGitalongBinary, InRepositoryRoot, GitalongParameters, OnePath, GitalongResults, GitalongErrorMessages);
+			if(!bUseLocalSpread)
+			{
+				RunGitalongStatus(InPathToGitalongBinary, InRepositoryRoot, OnePath, GitalongResults);
+			}
 			ParseStatusResults(InPathToGitBinary, InPathToGitalongBinary, InRepositoryRoot, OnePath, Results, GitalongResults, OutStates);
 		}
 	}
 
+	if(bUseLocalSpread)
+	{
+		for(int32 StateIndex = FirstStateIndex; StateIndex < OutStates.Num(); StateIndex++)
+		{
+			Provider.GetSpreadEngine().Apply(Provider.GetClaimIndex(), OutStates[StateIndex]);
+		}
+	}
+
+	// Claims still waiting in the journal are ours, unless someone else got there first
+	FGitSourceControlClaimJournal& ClaimJournal = Provider.GetClaimJournal();
+	if(ClaimJournal.IsRunning())
+	{
+		const FString RootPrefix = InRepositoryRoot / TEXT("");
+		for(int32 StateIndex = FirstStateIndex; StateIndex < OutStates.Num(); StateIndex++)
+		{
+			FGitSourceControlState& State = OutStates[StateIndex];
+			FString RelativeFilename = State.LocalFilename;
+			FPaths::MakePathRelativeTo(RelativeFilename, *RootPrefix);
+			// Only spread served from the last known statuses gets a time stamp, live spread keeps zero
+			FString LastKnownStatus;
+			FDateTime LastKnownTimeStamp;
+			if(!ClaimJournal.IsOnline() && ClaimJournal.GetLastKnownStatus(RelativeFilename, LastKnownStatus, LastKnownTimeStamp))
+			{
+				State.SpreadTimeStamp = LastKnownTimeStamp;
+			}
+			if(ClaimJournal.IsClaimPending(State.LocalFilename))
+			{
+				if(State.IsCheckedOutOther())
+				{
+					if(ClaimJournal.IsOnline())
+					{
+						ClaimJournal.DiscardClaim(State.LocalFilename);
+					}
+				}
+				else
+				{
+					State.LastCommitSpread = ECommitSpread::LocalUncommitted;
+				}
+			}
+		}
+	}
+
 	return bResults;
 }
 
+// Run a single Gitalong "status" command on the whole repository to get all the files claimed by the team.
+bool RunGetClaims(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, TArray<FString>& OutErrorMessages, TArray<FGitSourceControlState>& OutStates)
+{
+	// The whole repository can list many thousands of files: parsed straight from the bytes of the output
+	FGitOutput Results;
+	TArray<FString> Files;
+	Files.Add(InRepositoryRoot);
+	const bool bResult = RunCommandInternalOutput(TEXT("status"), InPathToGitalongBinary, InRepositoryRoot, TArray<FString>(), Files, EGitRecordSeparator::NewLine, Results, OutErrorMessages);
+	if(bResult)
+	{
+		OutStates.Reserve(OutStates.Num() + Results.Num());
+		for(int32 IdxResult = 0; IdxResult < Results.Num(); IdxResult++)
+		{
+			const FUtf8StringView Result = Results[IdxResult];
+			const FUtf8StringView RelativeFilename = FilenameFromGitalongStatus(Result);
+			if(RelativeFilename.IsEmpty())
+			{
+				continue;
+			}
+			const FGitalongStatusParser StatusParser(Result);
+			if(StatusParser.LastCommitSpread == ECommitSpread::Unknown)
+			{
+				// Not claimed by anyone
+				continue;
+			}
+			FGitSourceControlState FileState(FPaths::ConvertRelativePathToFull(InRepositoryRoot, GitSourceControlOutput::ToString(RelativeFilename)));
+			ApplyGitalongStatus(StatusParser, FileState);
+			OutStates.Add(MoveTemp(FileState));
+		}
+	}
+	return bResult;
+}
+
+// Run a single Git "diff-tree" command to list files changed by the commits of a revision that are not in HEAD.
+bool RunGetIncomingChanges(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InRevision, TArray<FString>& OutErrorMessages, TArray<FString>& OutFiles)
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	const FGitVersion& GitVersion = GitSourceControl.GetProvider().GetGitVersion();
+
+	TArray<FString> Results;
+	TArray<FString> Parameters;
+	bool bResult;
+	if(GitVersion.IsGreaterOrEqualThan(2, 30))
+	{
+		Parameters.Add(TEXT("-r"));
+		Parameters.Add(TEXT("--name-only"));
+		Parameters.Add(TEXT("--merge-base")); // only the changes of the incoming commits, not the reverse of ours
+		Parameters.Add(TEXT("HEAD"));
+		Parameters.Add(InRevision);
+		bResult = RunCommand(TEXT("diff-tree"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), Results, OutErrorMessages);
+	}
+	else
+	{
+		// Older versions fall-back on the three dots notation of "git diff"
+		Parameters.Add(TEXT("--name-only"));
+		Parameters.Add(FString::Printf(TEXT("HEAD...%s"), *InRevision));
+		bResult = RunCommand(TEXT("diff"), InPathToGitBinary, InRepositoryRoot, Parameters, TArray<FString>(), Results, OutErrorMessages);
+	}
+
+	if(bResult)
+	{
+		OutFiles.Reserve(OutFiles.Num() + Results.Num());
+		for(const FString& Result : Results)
+		{
+			OutFiles.Add(FPaths::ConvertRelativePathToFull(InRepositoryRoot, Result));
+		}
+	}
+	return bResult;
+}
+
 // Run a Git `cat-file --filters` command to dump the binary content of a revision into a file.
 bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InDumpFileName)
 {
@@ -1303,63 +1673,72 @@ Date:   2014-2015-05-12 11:28:14 +0200
 A	Content/Blueprints/Blueprint_CeilingLight.uasset
 C099	Content/Textures/T_Concrete_Poured_N.uasset Content/Textures/T_Concrete_Poured_N2.uasset
 */
-static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlHistory& OutHistory)
+static void ParseLogResults(const FGitOutput& InResults, FGitSourceControlCommitTable& InCommitTable, TGitSourceControlHistory& OutHistory)
 {
-	TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> SourceControlRevision = MakeShareable(new FGitSourceControlRevision);
-	for(const auto& Result : InResults)
+	FGitCommit Commit;
+	FString Action;
+	FString Filename;
+	// End of a commit: share its metadata with the revisions of the other files it touched
+	auto AddRevision = [&]()
+	{
+		if(!Commit.CommitId.IsEmpty())
+		{
+			TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> SourceControlRevision = MakeShared<FGitSourceControlRevision, ESPMode::ThreadSafe>(InCommitTable.FindOrAdd(MoveTemp(Commit)));
+			SourceControlRevision->Action = MoveTemp(Action);
+			SourceControlRevision->Filename = MoveTemp(Filename);
+			OutHistory.Add(MoveTemp(SourceControlRevision));
+			Commit = FGitCommit();
+			GetParseAllocationCounts().HeapCopies++;
+		}
+	};
+	GetParseAllocationCounts().Lines += InResults.Num();
+	for(int32 IdxResult = 0; IdxResult < InResults.Num(); IdxResult++)
 	{
-		if(Result.StartsWith(TEXT("commit "))) // Start of a new commit
+		const FUtf8StringView Result = InResults[IdxResult];
+		if(Result.StartsWith(UTF8TEXTVIEW("commit "))) // Start of a new commit
 		{
 			// End of the previous commit
-			if(SourceControlRevision->RevisionNumber != 0)
-			{
-				OutHistory.Add(MoveTemp(SourceControlRevision));
+			AddRevision();
 
-				SourceControlRevision = MakeShareable(new FGitSourceControlRevision);
-			}
-			SourceControlRevision->CommitId = Result.RightChop(7); // Full commit SHA1 hexadecimal string
-			SourceControlRevision->ShortCommitId = SourceControlRevision->CommitId.Left(8); // Short revision ; first 8 hex characters (max that can hold a 32 bit integer)
-			SourceControlRevision->CommitIdNumber = FParse::HexNumber(*SourceControlRevision->ShortCommitId);
-			SourceControlRevision->RevisionNumber = -1; // RevisionNumber will be set at the end, based off the index in the History
+			Commit.CommitId = GitSourceControlOutput::ToString(Result.RightChop(7)); // Full commit SHA1 hexadecimal string
+			Commit.ShortCommitId = Commit.CommitId.Left(8); // Short revision ; first 8 hex characters (max that can hold a 32 bit integer)
+			Commit.CommitIdNumber = FParse::HexNumber(*Commit.ShortCommitId);
 		}
-		else if(Result.StartsWith(TEXT("Author: "))) // Author name & email
+		else if(Result.StartsWith(UTF8TEXTVIEW("Author: "))) // Author name & email
 		{
 			// Remove the 'email' part of the UserName
-			FString UserNameEmail = Result.RightChop(8);
+			const FUtf8StringView UserNameEmail = Result.RightChop(8);
 			int32 EmailIndex = 0;
-			if(UserNameEmail.FindLastChar('<', EmailIndex))
+			if(UserNameEmail.FindLastChar(UTF8CHAR('<'), EmailIndex))
 			{
-				SourceControlRevision->UserName = UserNameEmail.Left(EmailIndex - 1);
+				Commit.UserName = GitSourceControlOutput::ToString(UserNameEmail.Left(EmailIndex - 1));
 			}
 		}
-		else if(Result.StartsWith(TEXT("Date:   "))) // Commit date
+		else if(Result.StartsWith(UTF8TEXTVIEW("Date:   "))) // Commit date
 		{
-			FString Date = Result.RightChop(8);
-			SourceControlRevision->Date = FDateTime::FromUnixTimestamp(FCString::Atoi(*Date));
+			// raw date: seconds since the epoch, then the timezone (records are followed by a separator or the final NUL of the output)
+			Commit.Date = FDateTime::FromUnixTimestamp(FCStringAnsi::Atoi64((const ANSICHAR*)Result.GetData() + 8));
 		}
-	//	else if(Result.IsEmpty()) // empty line before/after commit message has already been taken care by FString::ParseIntoArray()
-		else if(Result.StartsWith(TEXT("    ")))  // Multi-lines commit message
+	//	else if(Result.IsEmpty()) // empty lines before/after commit message are already dropped when splitting the output
+		else if(Result.StartsWith(UTF8TEXTVIEW("    ")))  // Multi-lines commit message
 		{
-			SourceControlRevision->Description += Result.RightChop(4);
-			SourceControlRevision->Description += TEXT("\n");
+			Commit.Description += GitSourceControlOutput::ToString(Result.RightChop(4));
+			Commit.Description += TEXT("\n");
 		}
 		else // Name of the file, starting with an uppercase status letter ("A"/"M"...)
 		{
-			const TCHAR Status = Result[0];
-			SourceControlRevision->Action = LogStatusToString(Status); // Readable action string ("Added", Modified"...) instead of "A"/"M"...
+			const TCHAR Status = (TCHAR)Result[0];
+			Action = LogStatusToString(Status); // Readable action string ("Added", Modified"...) instead of "A"/"M"...
 			// Take care of special case for Renamed/Copied file: extract the second filename after second tabulation
 			int32 IdxTab;
-			if(Result.FindLastChar('\t', IdxTab))
+			if(Result.FindLastChar(UTF8CHAR('\t'), IdxTab))
 			{
-				SourceControlRevision->Filename = Result.RightChop(IdxTab + 1); // relative filename
+				Filename = GitSourceControlOutput::ToString(Result.RightChop(IdxTab + 1)); // relative filename
 			}
 		}
 	}
 	// End of the last commit
-	if(SourceControlRevision->RevisionNumber != 0)
-	{
-		OutHistory.Add(MoveTemp(SourceControlRevision));
-	}
+	AddRevision();
 
 	// Then set the revision number of each Revision based on its index (reverse order since the log starts with the most recent change)
 	for(int32 RevisionIndex = 0; RevisionIndex < OutHistory.Num(); RevisionIndex++)
@@ -1406,7 +1785,7 @@ bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepository
 {
 	bool bResults;
 	{
-		TArray<FString> Results;
+		FGitOutput Results;
 		TArray<FString> Parameters;
 		Parameters.Add(TEXT("--follow")); // follow file renames
 		Parameters.Add(TEXT("--date=raw"));
@@ -1421,10 +1800,11 @@ bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepository
 		}
 		TArray<FString> Files;
 		Files.Add(*InFile);
-		bResults = RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, OutErrorMessages);
+		bResults = RunCommandOutput(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, EGitRecordSeparator::NewLine, Results, OutErrorMessages);
 		if(bResults)
 		{
-			ParseLogResults(Results, OutHistory);
+			FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
+			ParseLogResults(Results, GitSourceControl.GetProvider().GetCommitTable(), OutHistory);
 		}
 	}
 	for(auto& Revision : OutHistory)
@@ -1450,30 +1830,52 @@ bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepository
 
 bool UpdateCachedStates(const TArray<FGitSourceControlState>& InStates)
 {
-	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>( "GitSourceControl" );
+	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>( "GitSourceControl" );
 	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
-	int NbStatesUpdated = 0;
+	TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> UpdatedStates;
 
 	for(const auto& InState : InStates)
 	{
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(InState.LocalFilename);
-		if(State->WorkingCopyState != InState.WorkingCopyState || State->LastCommitSpread != InState.LastCommitSpread)
+		// keep the team wide claim index up to date
+		Provider.GetClaimIndex().Update(InState);
+
+		// publish a new state only if something changed (can be called from any thread)
+		const TSharedPtr<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateCache().Update(InState.LocalFilename, [&InState](FGitSourceControlState& CachedState)
 		{
-			State->WorkingCopyState = InState.WorkingCopyState;
-			State->PendingResolveInfo.BaseRevision = InState.PendingResolveInfo.BaseRevision;
+			// authors, hosts and branches are interned: compared as integers
+			if(CachedState.WorkingCopyState == InState.WorkingCopyState && CachedState.LastCommitSpread == InState.LastCommitSpread && CachedState.SpreadTimeStamp == InState.SpreadTimeStamp
+				&& CachedState.LastCommitAuthor == InState.LastCommitAuthor && CachedState.LastCommitHost == InState.LastCommitHost
+				&& CachedState.LastCommitLocalBranches == InState.LastCommitLocalBranches && CachedState.LastCommitRemoteBranches == InState.LastCommitRemoteBranches
+				&& CachedState.LastCommitSha == InState.LastCommitSha)
+			{
+				return false;
+			}
+			CachedState.WorkingCopyState = InState.WorkingCopyState;
+			CachedState.PendingResolveInfo.BaseRevision = InState.PendingResolveInfo.BaseRevision;
 			// @todo Bug report: Workaround a bug with the Source Control Module not updating file state after a "Save".
-			// State->TimeStamp = InState.TimeStamp;
-			State->LastCommitSpread = InState.LastCommitSpread;
-			State->LastCommitSha =  InState.LastCommitSha;
-			State->LastCommitLocalBranches = InState.LastCommitLocalBranches;
-			State->LastCommitRemoteBranches = InState.LastCommitRemoteBranches;
-			State->LastCommitHost = InState.LastCommitHost;
-			State->LastCommitAuthor = InState.LastCommitAuthor;
-			NbStatesUpdated++;
+			// CachedState.TimeStamp = InState.TimeStamp;
+			CachedState.LastCommitSpread = InState.LastCommitSpread;
+			CachedState.LastCommitSha = InState.LastCommitSha;
+			CachedState.LastCommitLocalBranches = InState.LastCommitLocalBranches;
+			CachedState.LastCommitRemoteBranches = InState.LastCommitRemoteBranches;
+			CachedState.LastCommitHost = InState.LastCommitHost;
+			CachedState.LastCommitAuthor = InState.LastCommitAuthor;
+			CachedState.SpreadTimeStamp = InState.SpreadTimeStamp;
+			return true;
+		});
+		if(State.IsValid())
+		{
+			UpdatedStates.Add(State.ToSharedRef());
 		}
 	}
 
-	return (NbStatesUpdated > 0);
+	// When Gitalong manages permissions, only the files whose state changed need their read-only flag checked
+	if(UpdatedStates.Num() > 0 && Provider.GetGitalongConfig().ModifiesPermissions())
+	{
+		Provider.GetPermissionManager().Apply(UpdatedStates);
+	}
+
+	return (UpdatedStates.Num() > 0);
 }
 
 /**
@@ -1521,4 +1923,23 @@ void RemoveRedundantErrors(FGitSourceControlCommand& InCommand, const FString& I
 	}
 }
 
+void DisplayRejectedClaimsNotification(const TArray<FString>& InRejectedFiles, const FString& InAuthor)
+{
+	FString Filenames;
+	for(const FString& File : InRejectedFiles)
+	{
+		Filenames += TEXT("\n");
+		Filenames += FPaths::GetBaseFilename(File);
+	}
+
+	const FText NotificationText = InAuthor.IsEmpty()
+		? FText::Format(NSLOCTEXT("GitSourceControl", "CheckOut_Rejected", "Could not claim the following files, they are no longer checked out:{0}"), FText::FromString(Filenames))
+		: FText::Format(NSLOCTEXT("GitSourceControl", "CheckOut_RejectedBy", "{0} claimed the following files first, they are no longer checked out:{1}"), FText::FromString(InAuthor), FText::FromString(Filenames));
+	FNotificationInfo Info(NotificationText);
+	Info.ExpireDuration = 8.0f;
+	Info.bUseSuccessFailIcons = true;
+	Info.Image = FAppStyle::GetBrush(TEXT("NotificationList.FailImage"));
+	FSlateNotificationManager::Get().AddNotification(Info);
+}
+
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GitSourceControlRevision.h"
+#include "GitSourceControlOutput.h"
 
 class FGitSourceControlState;
 
@@ -133,6 +134,21 @@ bool GetRemoteUrl(const FString& InPathToGitBinary, const FString& InRepositoryR
  */
 bool RunCommand(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
 
+/**
+ * Run a Git command - output is kept as raw UTF-8 bytes, split into records, for commands with large results.
+ *
+ * @param	InCommand			The Git command - e.g. status
+ * @param	InPathToBinary		The path to the Git or Gitalong binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory (can be empty)
+ * @param	InParameters		The parameters to the Git command
+ * @param	InFiles				The files to be operated on
+ * @param	InSeparator			How the results are split into records
+ * @param	OutResults			The results (from StdOut), all batches in the same output
+ * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunCommandOutput(const FString& InCommand, const FString& InPathToBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, EGitRecordSeparator InSeparator, FGitOutput& OutResults, TArray<FString>& OutErrorMessages);
+
 /**
  * Run a Git "commit" command by batches.
  *
@@ -156,6 +172,19 @@ bool RunCommit(const FString& InPathToGitBinary, const FString& InRepositoryRoot
  * @returns true if the command succeeded and returned no errors
  */
 bool RunClaim(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
+
+/**
+ * Run a Gitalong "claim" or "update" command, or commit it to the claim journal to be replayed in the background when enabled.
+ *
+ * @param	InCommand				The Gitalong command, "claim" or "update"
+ * @param	InPathToGitalongBinary	The path to the Gitalong binary
+ * @param	InRepositoryRoot		The Git repository from where to run the command
+ * @param	InFiles					The files to be operated on
+ * @param	OutResults				The results (from StdOut) as an array per-line, empty when journaled
+ * @param	OutErrorMessages		Any errors (from StdErr) as an array per-line
+ * @returns true if the command succeeded or was journaled
+ */
+bool RunGitalongCommand(const FString& InCommand, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
 	
 /**
  * Run a Git "status" command and parse it.
@@ -169,6 +198,29 @@ bool RunClaim(const FString& InPathToGitalongBinary, const FString& InRepository
  */
 bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutErrorMessages, TArray<FGitSourceControlState>& OutStates);
 
+/**
+ * Run a single Gitalong "status" command on the whole repository to get all the files claimed by the team.
+ *
+ * @param	InPathToGitalongBinary	The path to the Gitalong binary
+ * @param	InRepositoryRoot		The Git repository from where to run the command
+ * @param	OutErrorMessages		Any errors (from StdErr) as an array per-line
+ * @param	OutStates				States of the claimed files, with only their Gitalong spread information
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunGetClaims(const FString& InPathToGitalongBinary, const FString& InRepositoryRoot, TArray<FString>& OutErrorMessages, TArray<FGitSourceControlState>& OutStates);
+
+/**
+ * Run a single Git "diff-tree" command to list files changed by the commits of a revision that are not in HEAD.
+ *
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command
+ * @param	InRevision			The incoming revision, usually FETCH_HEAD
+ * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
+ * @param	OutFiles			Absolute filenames changed since the merge base of HEAD and the revision
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunGetIncomingChanges(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InRevision, TArray<FString>& OutErrorMessages, TArray<FString>& OutFiles);
+
 /**
  * Run a Git "cat-file" command to dump the binary content of a revision into a file.
  *
@@ -193,7 +245,7 @@ bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepository
 bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory);
 
 /**
- * Helper function for various commands to update cached states.
+ * Helper function for various commands to publish new states to the cache, from any thread.
  * @returns true if any states were updated
  */
 bool UpdateCachedStates(const TArray<FGitSourceControlState>& InStates);
@@ -204,4 +256,25 @@ bool UpdateCachedStates(const TArray<FGitSourceControlState>& InStates);
  */
 void RemoveRedundantErrors(FGitSourceControlCommand& InCommand, const FString& InFilter);
 
+/** Allocation counts of the parsing done on a thread, logged by each command as the plugin has no benchmark target */
+struct FParseAllocationCounts
+{
+	/** Status and log lines parsed */
+	int32 Lines = 0;
+	/** Bytes of transient fields taken from the memory stack */
+	int32 StackBytes = 0;
+	/** Strings and revisions copied to the heap from the parsed lines */
+	int32 HeapCopies = 0;
+};
+
+/** Allocation counts of the parsing done on the calling thread, reset by each command */
+FParseAllocationCounts& GetParseAllocationCounts();
+
+/**
+ * Tell the user that files they were already allowed to edit could not be claimed (game thread only)
+ * @param	InRejectedFiles		Files that are no longer checked out
+ * @param	InAuthor			Teammate who claimed them first, if known
+ */
+void DisplayRejectedClaimsNotification(const TArray<FString>& InRejectedFiles, const FString& InAuthor);
+
 }
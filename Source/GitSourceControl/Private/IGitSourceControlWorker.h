@@ -13,6 +13,15 @@ public:
 	 */
 	virtual FName GetName() const = 0;
 
+	/**
+	 * Gives the worker a chance to look at or update cached states before the command is issued. This is always executed on the main thread.
+	 * @returns true if states were updated
+	 */
+	virtual bool PrepareStates( class FGitSourceControlCommand& InCommand )
+	{
+		return false;
+	}
+
 	/**
 	 * Function that actually does the work. Can be executed on another thread.
 	 */